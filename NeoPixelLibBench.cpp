@@ -0,0 +1,631 @@
+/*
+ * NeoPixelLibBench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Timing sketch for the wrapper internals.  Build with __BENCH defined
+ * (instead of __TEST) and read the results on the serial monitor.
+ */
+
+#include "NeopixelWrapper.h"
+
+#ifdef __BENCH
+
+// Longest strip measured; 1000 LEDs needs a board with more than 4KB RAM
+#ifndef BENCH_MAX_LEDS
+#define BENCH_MAX_LEDS	300
+#endif
+
+#define BENCH_PASSES	50
+
+// Strip driven through FastLED for the per-effect runs
+#define BENCH_STRIP_LEDS	60
+#define BENCH_RUN_TIME		2000
+#define BENCH_RING_BYTES	1024
+
+volatile uint32_t benchEnd = 0;
+
+// Stands in for a DMA or SPI driver handing the wire buffer over
+uint8_t benchWire[BENCH_STRIP_LEDS * 4];
+
+void benchDriver(const uint8_t *data, uint16_t length)
+{
+	if( length > sizeof(benchWire) )
+	{
+		length = sizeof(benchWire);
+	}
+	memcpy(benchWire, data, length);
+}
+
+/**
+ * Exposes the protected internals of the wrapper to the benchmarks.
+ * Owns its pixel buffers so strip length can change between runs.
+ */
+class NeopixelBench : public NeopixelWrapper
+{
+public:
+	CRGB *reference;
+
+	boolean begin()
+	{
+		leds = (CRGB *) malloc(sizeof(CRGB) * BENCH_MAX_LEDS);
+		reference = (CRGB *) malloc(sizeof(CRGB) * BENCH_MAX_LEDS);
+		return (leds != 0 && reference != 0);
+	}
+
+	void resize(uint16_t numLeds)
+	{
+		stripLength = numLeds;
+	}
+
+	/**
+	 * Lights roughly litPercent of the strip with random colors
+	 * and records exactly those pixels in the active bitmap
+	 */
+	void seed(uint8_t litPercent)
+	{
+		fill_solid(leds, stripLength, CRGB::Black);
+		if( activeMap != 0 )
+		{
+			memset(activeMap, 0, (stripLength + 7) / 8);
+		}
+		for(uint16_t i=0; i<stripLength; i++)
+		{
+			if( random8(100) < litPercent )
+			{
+				leds[i] = CHSV(random8(), 255, 255);
+				if( activeMap != 0 )
+				{
+					activeMap[i >> 3] |= (1 << (i & 0x07));
+				}
+			}
+		}
+		memcpy(reference, leds, sizeof(CRGB) * stripLength);
+	}
+
+	/**
+	 * Times full-scan fade against sparse fade on the same frames
+	 */
+	void fade(uint8_t litPercent)
+	{
+		uint32_t fullTime = 0;
+		uint32_t sparseTime = 0;
+		boolean match = true;
+
+		setSparseFade(true);
+		for(uint8_t pass=0; pass<BENCH_PASSES; pass++)
+		{
+			seed(litPercent);
+
+			uint32_t start = micros();
+			fadeToBlackBy(reference, stripLength, 20);
+			fullTime += micros() - start;
+
+			start = micros();
+			fadeStrip(20);
+			sparseTime += micros() - start;
+
+			if( memcmp(reference, leds, sizeof(CRGB) * stripLength) != 0 )
+			{
+				match = false;
+			}
+		}
+		setSparseFade(false);
+
+		Serial.print(F("fade leds="));
+		Serial.print(stripLength);
+		Serial.print(F(" lit%="));
+		Serial.print(litPercent);
+		Serial.print(F(" full_us="));
+		Serial.print(fullTime / BENCH_PASSES);
+		Serial.print(F(" sparse_us="));
+		Serial.print(sparseTime / BENCH_PASSES);
+		Serial.println(match ? F(" match") : F(" MISMATCH"));
+	}
+
+	/**
+	 * Times the per-pixel loops the effects used to run against the
+	 * span primitives that replaced them
+	 */
+	void spans()
+	{
+		uint32_t legacy = 0;
+		uint32_t fast = 0;
+		uint32_t start;
+		CRGB color = CRGB::Orange;
+
+		for(uint8_t pass=0; pass<BENCH_PASSES; pass++)
+		{
+			start = micros();
+			for(uint16_t i=0; i<stripLength; i++)
+			{
+				leds[i] = color;
+			}
+			legacy += micros() - start;
+
+			start = micros();
+			spanFill(leds, stripLength, color);
+			fast += micros() - start;
+		}
+		printSpan(F("fill"), legacy, fast);
+
+		legacy = 0;
+		fast = 0;
+		for(uint8_t pass=0; pass<BENCH_PASSES; pass++)
+		{
+			uint8_t pattern = 0x33;
+			start = micros();
+			uint8_t j = 0;
+			for(uint16_t i=0; i<stripLength; i++)
+			{
+				if( (pattern >> j) & 0x01 )
+				{
+					leds[i] = color;
+				}
+				else
+				{
+					leds[i] = CRGB::Black;
+				}
+				j = (j + 1) & 0x07;
+			}
+			legacy += micros() - start;
+
+			start = micros();
+			for(uint8_t k=0; k<8; k++)
+			{
+				reference[k] = ((pattern >> k) & 0x01) ? color : CRGB::Black;
+			}
+			spanRepeat(reference, stripLength, reference, 8);
+			fast += micros() - start;
+		}
+		printSpan(F("pattern"), legacy, fast);
+	}
+
+	/**
+	 * Times the output stage converting a whole frame, a frame with one
+	 * changed pixel and a repeated frame
+	 */
+	void wire(NeopixelOutput &out)
+	{
+		uint32_t full = 0;
+		uint32_t one = 0;
+		uint32_t repeat = 0;
+		uint32_t start;
+
+		if( out.begin(stripLength, WIRE_GRB) == false )
+		{
+			return;
+		}
+		seed(100);
+		for(uint8_t pass=0; pass<BENCH_PASSES; pass++)
+		{
+			// a brightness change reconverts every pixel
+			out.setBrightness(pass & 0x01 ? 200 : 201);
+			start = micros();
+			out.update(leds);
+			full += micros() - start;
+
+			leds[random16(stripLength)] = CHSV(random8(), 255, 255);
+			start = micros();
+			out.update(leds);
+			one += micros() - start;
+
+			start = micros();
+			out.update(leds);
+			repeat += micros() - start;
+		}
+
+		Serial.print(F("wire leds="));
+		Serial.print(stripLength);
+		Serial.print(F(" full_us="));
+		Serial.print(full / BENCH_PASSES);
+		Serial.print(F(" one_us="));
+		Serial.print(one / BENCH_PASSES);
+		Serial.print(F(" repeat_us="));
+		Serial.println(repeat / BENCH_PASSES);
+	}
+
+	/**
+	 * Times dithering a 16 bit frame down to 8 bits against the plain
+	 * 8 bit brightness scale it replaces
+	 */
+	void dither(NeopixelDither &d)
+	{
+		uint32_t plain = 0;
+		uint32_t dithered = 0;
+		uint32_t start;
+
+		if( d.begin(stripLength) == false )
+		{
+			return;
+		}
+		for(uint8_t pass=0; pass<BENCH_PASSES; pass++)
+		{
+			seed(100);
+			start = micros();
+			for(uint16_t i=0; i<stripLength; i++)
+			{
+				leds[i].nscale8(2);
+			}
+			plain += micros() - start;
+
+			d.fill(CRGB::Orange, random16());
+			start = micros();
+			d.render(leds, 2);
+			dithered += micros() - start;
+		}
+
+		Serial.print(F("dither leds="));
+		Serial.print(stripLength);
+		Serial.print(F(" plain_us="));
+		Serial.print(plain / BENCH_PASSES);
+		Serial.print(F(" dither_us="));
+		Serial.print(dithered / BENCH_PASSES);
+		Serial.print(F(" frame%="));
+		Serial.println(((dithered / BENCH_PASSES) * 100) / (1000000UL / DEFAULT_FPS));
+	}
+
+	/**
+	 * Times showStrip() for a frame where one pixel changed, the case of
+	 * pattern and randomFlash, and for the same frame shown again: first
+	 * through FastLED.show(), which converts every pixel and clocks the
+	 * strip out, then through the output stage and benchDriver.  The
+	 * saving is the CPU time per frame a driver that sends in the
+	 * background gives back; wire_time_us is how much of FastLED's time
+	 * is spent clocking bits out.  Needs FastLED initialized.
+	 */
+	void show(NeopixelOutput &out)
+	{
+		uint32_t plain[2] = { 0, 0 };
+		uint32_t staged[2] = { 0, 0 };
+
+		if( out.begin(stripLength, WIRE_GRB) == false )
+		{
+			return;
+		}
+		out.setDriver(benchDriver);
+		showFrames(plain);
+		if( setOutput(&out) == false )
+		{
+			return;
+		}
+		showFrames(staged);
+		setOutput(0);
+
+		Serial.print(F("show leds="));
+		Serial.print(stripLength);
+		Serial.print(F(" fastled_one_us="));
+		Serial.print(plain[0] / BENCH_PASSES);
+		Serial.print(F(" fastled_repeat_us="));
+		Serial.print(plain[1] / BENCH_PASSES);
+		Serial.print(F(" stage_one_us="));
+		Serial.print(staged[0] / BENCH_PASSES);
+		Serial.print(F(" stage_repeat_us="));
+		Serial.print(staged[1] / BENCH_PASSES);
+		Serial.print(F(" saved_one_us="));
+		Serial.print((int32_t) (plain[0] - staged[0]) / BENCH_PASSES);
+		Serial.print(F(" saved_repeat_us="));
+		Serial.print((int32_t) (plain[1] - staged[1]) / BENCH_PASSES);
+		Serial.print(F(" wire_time_us="));
+		Serial.println(wireMicros());
+	}
+
+	/**
+	 * Adds up showStrip() time for a frame with one changed pixel into
+	 * total[0] and for showing it again into total[1]
+	 */
+	void showFrames(uint32_t *total)
+	{
+		uint32_t start;
+
+		seed(100);
+		for(uint8_t pass=0; pass<BENCH_PASSES; pass++)
+		{
+			leds[random16(stripLength)] = CHSV(random8(), 255, 255);
+			start = micros();
+			showStrip();
+			total[0] += micros() - start;
+
+			start = micros();
+			showStrip();
+			total[1] += micros() - start;
+		}
+	}
+
+	/**
+	 * Runs rainbowFade at low brightness with 8 bit rendering and then
+	 * through the dither stage, and reports the measured render + show
+	 * time per frame of each.  Needs FastLED initialized.
+	 */
+	void fadeFrames(NeopixelDither &d)
+	{
+		if( d.begin(stripLength) == false )
+		{
+			return;
+		}
+		setIntensity(2);
+		for(uint8_t run=0; run<2; run++)
+		{
+			setDither(run ? &d : 0);
+			frameCost = 0;
+			benchEnd = millis() + BENCH_RUN_TIME;
+			rainbowFade(0);
+			Serial.print(F("dither rainbowFade leds="));
+			Serial.print(stripLength);
+			Serial.print(run ? F(" 16bit") : F(" 8bit"));
+			Serial.print(F(" frame_us="));
+			Serial.print(frameCost);
+			Serial.print(F(" fps="));
+			Serial.println(getFramesPerSecond());
+		}
+		setDither(0);
+		setIntensity(64);
+	}
+
+	void printSpan(const __FlashStringHelper *name, uint32_t legacy, uint32_t fast)
+	{
+		Serial.print(name);
+		Serial.print(F(" leds="));
+		Serial.print(stripLength);
+		Serial.print(F(" loop_us="));
+		Serial.print(legacy / BENCH_PASSES);
+		Serial.print(F(" span_us="));
+		Serial.println(fast / BENCH_PASSES);
+	}
+};
+
+/**
+ * Times FFT and beat detection for one block size against the
+ * frame period at DEFAULT_FPS
+ */
+void benchAudio(NeopixelAudio &audio, uint16_t blockSize)
+{
+	int16_t samples[AUDIO_MAX_BLOCK];
+	uint32_t total = 0;
+
+	if( audio.begin(blockSize, DEFAULT_SAMPLE_RATE) == false )
+	{
+		return;
+	}
+
+	for(uint8_t pass=0; pass<BENCH_PASSES; pass++)
+	{
+		// 125Hz kick under a 1kHz tone plus noise
+		for(uint16_t i=0; i<blockSize; i++)
+		{
+			samples[i] = (sin16(i * 1024 + pass * 4096) >> 1) + (sin16(i * 8192) >> 2) + (int16_t)(random16() >> 4);
+		}
+		uint32_t start = micros();
+		audio.analyze(samples, blockSize);
+		total += micros() - start;
+	}
+
+	uint32_t average = total / BENCH_PASSES;
+	Serial.print(F("audio block="));
+	Serial.print(blockSize);
+	Serial.print(F(" us="));
+	Serial.print(average);
+	Serial.print(F(" frame%="));
+	Serial.println((average * 100) / (1000000UL / DEFAULT_FPS));
+}
+
+/**
+ * Runs each effect with the recorder attached and reports the
+ * compression ratio and recording cost per frame
+ */
+void benchRecorder(NeopixelWrapper &strip, NeopixelRecorder &recorder)
+{
+	strip.setRecorder(&recorder);
+	for(uint8_t effect=0; effect<8; effect++)
+	{
+		recorder.reset();
+		benchEnd = millis() + BENCH_RUN_TIME;
+		switch(effect)
+		{
+		case 0:
+			Serial.print(F("record rainbow"));
+			strip.rainbow(0, 0, WHITE);
+			break;
+		case 1:
+			Serial.print(F("record rainbowFade"));
+			strip.rainbowFade(0);
+			break;
+		case 2:
+			Serial.print(F("record confetti"));
+			strip.confetti(0, RAINBOW, 10);
+			break;
+		case 3:
+			Serial.print(F("record cylon"));
+			strip.cylon(0, RED);
+			break;
+		case 4:
+			Serial.print(F("record bpm"));
+			strip.bpm(0);
+			break;
+		case 5:
+			Serial.print(F("record juggle"));
+			strip.juggle(0);
+			break;
+		case 6:
+			Serial.print(F("record randomFlash"));
+			strip.randomFlash(0, 25, 25, WHITE, BLACK);
+			break;
+		case 7:
+			Serial.print(F("record pattern"));
+			strip.pattern(0, 0x33, LEFT, RED, WHITE, 50, 50);
+			break;
+		}
+
+		uint32_t frames = recorder.getFrames();
+		Serial.print(F(" frames="));
+		Serial.print(frames);
+		Serial.print(F(" dropped="));
+		Serial.print(recorder.getDrops());
+		Serial.print(F(" ratio_x10="));
+		Serial.print((recorder.getRawBytes() * 10) / (recorder.getEncodedBytes() + 1));
+		Serial.print(F(" us_per_frame="));
+		Serial.print(frames ? recorder.getRecordMicros() / frames : 0);
+		Serial.print(F(" fps="));
+		Serial.print(strip.getFramesPerSecond());
+		Serial.print(F(" max_fps="));
+		Serial.println(strip.getMaxFramesPerSecond());
+	}
+	strip.setRecorder(0);
+}
+
+/**
+ * Reports the RAM each part takes: object sizes, which are static when
+ * declared globally, and what begin()/initialize() allocate per LED
+ */
+void benchMemory()
+{
+	Serial.print(F("ram wrapper="));
+	Serial.print(sizeof(NeopixelWrapper));
+	Serial.print(F(" particles="));
+	Serial.print(sizeof(NeopixelParticles));
+	Serial.print(F(" audio="));
+	Serial.print(sizeof(NeopixelAudio));
+	Serial.print(F(" recorder="));
+	Serial.print(sizeof(NeopixelRecorder));
+	Serial.print(F(" queue="));
+	Serial.print(sizeof(NeopixelFrameQueue));
+	Serial.print(F(" output="));
+	Serial.print(sizeof(NeopixelOutput));
+	Serial.print(F(" dither="));
+	Serial.println(sizeof(NeopixelDither));
+
+	Serial.print(F("ram_per_led_x8 pixels="));
+	Serial.print(sizeof(CRGB) * 8);
+	Serial.print(F(" sparse_fade=1 queue="));
+	Serial.print(sizeof(CRGB) * FRAME_QUEUE_DEPTH * 8);
+	Serial.print(F(" output_rgb="));
+	Serial.print((sizeof(CRGB) + 3) * 8);
+	Serial.print(F(" output_rgbw="));
+	Serial.print((sizeof(CRGB) + 4) * 8);
+	Serial.print(F(" dither="));
+	Serial.println((sizeof(CRGB16) + 3) * 8);
+}
+
+NeopixelBench bench;
+NeopixelParticles particles;
+NeopixelAudio audio;
+NeopixelWrapper strip;
+NeopixelRecorder recorder;
+NeopixelOutput output;
+NeopixelDither dither;
+
+#if defined(ESP32)
+NeopixelFrameQueue queue;
+
+/**
+ * Output side of the pipeline, pinned to the other core
+ */
+void transmitTask(void *arg)
+{
+	for(;;)
+	{
+		if( strip.transmit() == false )
+		{
+			vTaskDelay(1);
+		}
+	}
+}
+
+/**
+ * Renders juggle on this core while the other core transmits, and
+ * reports throughput, hand-over latency and back-pressure stalls
+ */
+void benchPipeline()
+{
+	if( queue.begin(BENCH_STRIP_LEDS) == false )
+	{
+		return;
+	}
+	if( strip.setPipeline(&queue) == false )
+	{
+		return;
+	}
+	xTaskCreatePinnedToCore(transmitTask, "transmit", 2048, 0, 1, 0, 0);
+
+	queue.resetStats();
+	benchEnd = millis() + BENCH_RUN_TIME;
+	strip.juggle(0);
+
+	uint32_t frames = queue.getFrames();
+	Serial.print(F("pipeline frames="));
+	Serial.print(frames);
+	Serial.print(F(" fps="));
+	Serial.print((frames * 1000) / BENCH_RUN_TIME);
+	Serial.print(F(" latency_us="));
+	Serial.print(frames ? queue.getLatencyMicros() / frames : 0);
+	Serial.print(F(" max_latency_us="));
+	Serial.print(queue.getMaxLatencyMicros());
+	Serial.print(F(" stalls="));
+	Serial.println(queue.getStalls());
+}
+#endif
+
+const uint16_t benchLengths[] = { 50, 100, 300, 500, 1000 };
+const uint8_t benchLit[] = { 1, 5, 25, 100 };
+
+void setup()
+{
+	Serial.begin(115200);
+	benchMemory();
+	if( bench.begin() == false )
+	{
+		Serial.println(F("out of memory"));
+		return;
+	}
+
+	for(uint8_t l=0; l<sizeof(benchLengths)/sizeof(benchLengths[0]); l++)
+	{
+		if( benchLengths[l] > BENCH_MAX_LEDS )
+		{
+			break;
+		}
+		bench.resize(benchLengths[l]);
+		for(uint8_t f=0; f<sizeof(benchLit); f++)
+		{
+			bench.fade(benchLit[f]);
+		}
+		bench.spans();
+		bench.wire(output);
+		bench.dither(dither);
+	}
+
+	for(uint16_t blockSize=16; blockSize<=AUDIO_MAX_BLOCK; blockSize<<=1)
+	{
+		benchAudio(audio, blockSize);
+	}
+
+	if( strip.initialize(BENCH_STRIP_LEDS, 64) && recorder.begin(BENCH_STRIP_LEDS, BENCH_RING_BYTES) )
+	{
+		strip.setParticles(&particles);
+		benchRecorder(strip, recorder);
+		bench.resize(BENCH_STRIP_LEDS);
+		bench.show(output);
+		bench.fadeFrames(dither);
+#if defined(ESP32)
+		benchPipeline();
+#endif
+	}
+}
+
+void loop()
+{
+}
+
+uint8_t isCommandAvailable()
+{
+	return millis() >= benchEnd;
+}
+
+uint8_t commandDelay(uint32_t time)
+{
+	delay(time);
+	return isCommandAvailable();
+}
+
+#endif
@@ -0,0 +1,354 @@
+/*
+ * NeopixelAudio.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelAudio.h"
+
+#if defined(__AVR__) && !defined(AUDIO_NO_ADC_ISR)
+// analyzer fed by the ADC interrupt; 0 when not sampling
+static NeopixelAudio * volatile sampler = 0;
+#endif
+
+/**
+ * Constructor
+ */
+NeopixelAudio::NeopixelAudio()
+{
+	blockSize = 0;
+	bassBins = 1;
+	fillCount = 0;
+	peak = 1;
+	bassAverage = 0;
+	lastBeat = 0;
+	beatInterval = 60000 / DEFAULT_AUDIO_BPM;
+	level = 0;
+	hue = 0;
+	beat = false;
+}
+
+/**
+ * Sets the analysis block size and the rate samples are taken at.
+ *
+ * @blockSize - power of two from 8 to AUDIO_MAX_BLOCK
+ * @sampleRate - samples per second; used to locate the bass bins
+ *
+ * Returns false if the block size is not supported
+ */
+boolean NeopixelAudio::begin(uint16_t blockSize, uint16_t sampleRate)
+{
+	if( blockSize < 8 || blockSize > AUDIO_MAX_BLOCK || (blockSize & (blockSize - 1)) )
+	{
+		return false;
+	}
+
+	this->blockSize = blockSize;
+	fillCount = 0;
+
+	// bins below ~250Hz carry the kick drum
+	bassBins = ((uint32_t)250 * blockSize) / sampleRate;
+	if( bassBins < 1 )
+	{
+		bassBins = 1;
+	}
+
+	return true;
+}
+
+/**
+ * Queues one sample.  Safe to call from an ADC interrupt; samples are
+ * dropped while a full block is waiting for update().
+ */
+void NeopixelAudio::addSample(int16_t sample)
+{
+	uint16_t i = fillCount;
+	if( i < blockSize )
+	{
+		real[i] = sample;
+		fillCount = i + 1;
+	}
+}
+
+/**
+ * Analyzes the queued block if it is complete.  Called once per frame.
+ *
+ * Returns true if new results are available
+ */
+boolean NeopixelAudio::update()
+{
+	if( blockSize == 0 || fillCount < blockSize )
+	{
+		return false;
+	}
+
+	transform();
+	detect();
+	fillCount = 0;
+
+	return true;
+}
+
+/**
+ * Analyzes a block of samples supplied by the caller.  Short blocks are
+ * zero padded and long blocks truncated to the configured block size.
+ */
+void NeopixelAudio::analyze(const int16_t *samples, uint16_t count)
+{
+	if( blockSize == 0 )
+	{
+		return;
+	}
+
+	for(uint16_t i=0; i<blockSize; i++)
+	{
+		real[i] = (i < count) ? samples[i] : 0;
+	}
+
+	transform();
+	detect();
+	fillCount = 0;
+}
+
+/**
+ * Samples an analog pin continuously in the background.  On AVR the ADC
+ * runs free at F_CPU/128/13 (9615Hz at 16MHz) and every conversion is
+ * passed to addSample() from the ADC interrupt; begin() is called with
+ * that rate.  Samples that fall while FastLED.show() has interrupts off
+ * are lost.  analogRead() must not be used until stopSampling().
+ * Define AUDIO_NO_ADC_ISR if the sketch has its own ADC interrupt.
+ *
+ * On other boards, or with AUDIO_NO_ADC_ISR, this returns false; feed
+ * addSample() from the board's own sampler (e.g. a timer interrupt
+ * reading an ADC that does not block) and call begin() with its rate.
+ *
+ * @pin - analog pin, e.g. A0
+ *
+ * Returns false if the block size is not supported or there is no
+ * background sampler for this board
+ */
+boolean NeopixelAudio::startSampling(uint8_t pin, uint16_t blockSize)
+{
+#if defined(__AVR__) && !defined(AUDIO_NO_ADC_ISR)
+	if( begin(blockSize, F_CPU / 128 / 13) == false )
+	{
+		return false;
+	}
+	// pin to ADC channel the way analogRead() does it
+	if( pin >= A0 )
+	{
+		pin -= A0;
+	}
+#if defined(analogPinToChannel)
+	pin = analogPinToChannel(pin);
+#endif
+
+	sampler = this;
+	ADCSRA = 0;
+	ADCSRB = 0; // free running trigger
+#if defined(MUX5)
+	if( pin & 0x08 )
+	{
+		ADCSRB = _BV(MUX5);
+	}
+#endif
+	ADMUX = _BV(REFS0) | (pin & 0x07); // AVcc reference, right adjusted
+	ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+	ADCSRA |= _BV(ADSC);
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Stops background sampling and hands the ADC back to analogRead()
+ */
+void NeopixelAudio::stopSampling()
+{
+#if defined(__AVR__) && !defined(AUDIO_NO_ADC_ISR)
+	if( sampler == this )
+	{
+		// enabled, single conversions at the prescaler analogRead() expects
+		ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+		sampler = 0;
+	}
+#endif
+}
+
+/**
+ * Returns loudness 0-255, normalized to the recent peak
+ */
+uint8_t NeopixelAudio::getLevel()
+{
+	return level;
+}
+
+/**
+ * Returns the spectral centroid mapped onto the color wheel;
+ * bass heavy music is red, bright music toward blue
+ */
+uint8_t NeopixelAudio::getHue()
+{
+	return hue;
+}
+
+/**
+ * Returns the detected tempo
+ */
+uint8_t NeopixelAudio::getBeatsPerMinute()
+{
+	return 60000 / beatInterval;
+}
+
+/**
+ * Returns true once for every detected beat
+ */
+boolean NeopixelAudio::getBeat()
+{
+	boolean b = beat;
+	beat = false;
+	return b;
+}
+
+/**
+ * Reads a 10 bit ADC pin and centers it on zero at full int16 scale.
+ * analogRead() waits for the conversion (about 110us on AVR), so this
+ * suits polling a few samples per frame; for a steady sample rate use
+ * startSampling().
+ */
+int16_t NeopixelAudio::readAnalog(uint8_t pin)
+{
+	return (analogRead(pin) - 512) << 6;
+}
+
+////////////////////////////////////////
+// BEGIN PRIVATE FUNCTIONS
+////////////////////////////////////////
+
+/**
+ * In place radix-2 FFT on real[]/imag[] in Q15.  Each stage halves the
+ * butterflies so nothing can overflow; twiddles come from FastLED's
+ * sin16/cos16 instead of a table.
+ */
+void NeopixelAudio::transform()
+{
+	uint16_t n = blockSize;
+	uint16_t i, j, bit;
+
+	memset(imag, 0, sizeof(int16_t) * n);
+
+	// bit reversed reordering
+	j = 0;
+	for(i=1; i<n; i++)
+	{
+		bit = n >> 1;
+		while( j & bit )
+		{
+			j ^= bit;
+			bit >>= 1;
+		}
+		j ^= bit;
+		if( i < j )
+		{
+			int16_t t = real[i];
+			real[i] = real[j];
+			real[j] = t;
+		}
+	}
+
+	for(uint16_t len=2; len<=n; len<<=1)
+	{
+		uint16_t half = len >> 1;
+		uint16_t step = 65536UL / len;
+		for(uint16_t k=0; k<half; k++)
+		{
+			int16_t wr = cos16(k * step);
+			int16_t wi = -sin16(k * step);
+			for(i=k; i<n; i+=len)
+			{
+				j = i + half;
+				int16_t tr = ((int32_t)wr * real[j] - (int32_t)wi * imag[j]) >> 15;
+				int16_t ti = ((int32_t)wr * imag[j] + (int32_t)wi * real[j]) >> 15;
+				real[j] = (real[i] - tr) >> 1;
+				imag[j] = (imag[i] - ti) >> 1;
+				real[i] = (real[i] + tr) >> 1;
+				imag[i] = (imag[i] + ti) >> 1;
+			}
+		}
+	}
+}
+
+/**
+ * Derives level, hue and beats from the transformed block
+ */
+void NeopixelAudio::detect()
+{
+	uint16_t bins = blockSize >> 1;
+	uint32_t total = 0;
+	uint32_t bass = 0;
+	uint32_t moment = 0;
+
+	// skip DC; magnitude is approximated as max + min/2
+	for(uint16_t k=1; k<bins; k++)
+	{
+		uint16_t a = abs(real[k]);
+		uint16_t b = abs(imag[k]);
+		uint16_t mag = (a > b) ? a + (b >> 1) : b + (a >> 1);
+		total += mag;
+		moment += (uint32_t)mag * k;
+		if( k <= bassBins )
+		{
+			bass += mag;
+		}
+	}
+
+	// level with a slowly decaying peak as automatic gain control
+	peak -= peak >> 7;
+	if( total > peak )
+	{
+		peak = total;
+	}
+	level = (total * 255) / (peak + 1);
+
+	if( total > 0 )
+	{
+		// keep moment * 256 within 32 bits
+		uint32_t weight = total;
+		while( weight > 0xFFFF )
+		{
+			weight >>= 1;
+			moment >>= 1;
+		}
+		hue = ((moment << 8) / weight) / bins;
+	}
+
+	// beat when bass jumps half again above its running average
+	uint32_t now = millis();
+	uint32_t interval = now - lastBeat;
+	if( bass * 2 > bassAverage * 3 && bass > 16 && interval > 300 )
+	{
+		if( interval < 1500 )
+		{
+			beatInterval = (beatInterval * 3 + interval) / 4;
+		}
+		lastBeat = now;
+		beat = true;
+	}
+	bassAverage = bassAverage - (bassAverage >> 3) + (bass >> 3);
+}
+
+#if defined(__AVR__) && !defined(AUDIO_NO_ADC_ISR)
+/**
+ * ADC conversion complete; the next conversion is already running
+ */
+ISR(ADC_vect)
+{
+	NeopixelAudio *a = sampler;
+	if( a != 0 )
+	{
+		a->addSample(((int16_t)ADC - 512) << 6);
+	}
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ * NeopixelAudio.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELAUDIO_H_
+#define NEOPIXELAUDIO_H_
+
+#include <Arduino.h>
+#include <FastLed.h>
+
+// Largest block analyze() accepts; costs 4 bytes of RAM per sample
+#ifndef AUDIO_MAX_BLOCK
+#define AUDIO_MAX_BLOCK		128
+#endif
+
+#define DEFAULT_AUDIO_BLOCK		64
+#define DEFAULT_SAMPLE_RATE		8000
+#define DEFAULT_AUDIO_BPM		62
+
+/**
+ * Fixed point FFT and beat detector.  Samples arrive either one at a
+ * time through addSample() (on AVR, startSampling() runs the ADC free
+ * and feeds it from the conversion complete interrupt) or as a whole
+ * block through analyze() (e.g. PCM read from a WAV file on the host).
+ * Results are held until the next block and read by the effects each
+ * frame.
+ */
+class NeopixelAudio
+{
+public:
+	NeopixelAudio();
+	boolean begin(uint16_t blockSize, uint16_t sampleRate);
+	void addSample(int16_t sample);
+	boolean update();
+	void analyze(const int16_t *samples, uint16_t count);
+	boolean startSampling(uint8_t pin, uint16_t blockSize);
+	void stopSampling();
+
+	uint8_t getLevel();
+	uint8_t getHue();
+	uint8_t getBeatsPerMinute();
+	boolean getBeat();
+
+	static int16_t readAnalog(uint8_t pin);
+
+protected:
+	uint16_t blockSize;
+	uint16_t bassBins;
+	volatile uint16_t fillCount;	// samples collected toward the next block
+
+	int16_t real[AUDIO_MAX_BLOCK];	// input block, transformed in place
+	int16_t imag[AUDIO_MAX_BLOCK];
+
+	uint32_t peak;			// automatic gain control for level
+	uint32_t bassAverage;	// running bass energy for beat detection
+	uint32_t lastBeat;
+	uint16_t beatInterval;	// smoothed milliseconds between beats
+
+	uint8_t level;
+	uint8_t hue;
+	boolean beat;
+
+	void transform();
+	void detect();
+};
+
+#endif /* NEOPIXELAUDIO_H_ */
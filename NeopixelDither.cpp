@@ -0,0 +1,153 @@
+/*
+ * NeopixelDither.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelDither.h"
+
+/**
+ * Constructor
+ */
+NeopixelDither::NeopixelDither()
+{
+	numLeds = 0;
+	pixels = 0;
+	error = 0;
+	correction = TypicalLEDStrip;
+}
+
+/**
+ * Allocates the 16 bit buffer and the residuals.  Calling again frees
+ * the previous buffers first.
+ */
+boolean NeopixelDither::begin(uint16_t numLeds)
+{
+	free(pixels);
+	free(error);
+
+	this->numLeds = 0;
+	pixels = (CRGB16 *) malloc(sizeof(CRGB16) * numLeds);
+	error = (uint8_t *) malloc(3 * numLeds);
+	if( pixels == 0 || error == 0 )
+	{
+		free(pixels);
+		free(error);
+		pixels = 0;
+		error = 0;
+		return false;
+	}
+
+	memset(pixels, 0, sizeof(CRGB16) * numLeds);
+	// start half way so the first frame rounds instead of truncating
+	memset(error, 0x80, 3 * numLeds);
+	this->numLeds = numLeds;
+
+	return true;
+}
+
+/**
+ * Sets every pixel to color at level (0-65535)
+ */
+void NeopixelDither::fill(CRGB color, uint16_t level)
+{
+	CRGB16 c;
+	c.r = expand(color.r, level);
+	c.g = expand(color.g, level);
+	c.b = expand(color.b, level);
+
+	for(uint16_t i=0; i<numLeds; i++)
+	{
+		pixels[i] = c;
+	}
+}
+
+/**
+ * Moves one pixel amount/256 of the way toward color at level, the
+ * 16 bit counterpart of nblend()
+ */
+void NeopixelDither::blend(uint16_t index, CRGB color, uint16_t level, uint8_t amount)
+{
+	if( index >= numLeds )
+	{
+		return;
+	}
+
+	CRGB16 &p = pixels[index];
+	p.r += ((int32_t)expand(color.r, level) - p.r) * amount >> 8;
+	p.g += ((int32_t)expand(color.g, level) - p.g) * amount >> 8;
+	p.b += ((int32_t)expand(color.b, level) - p.b) * amount >> 8;
+}
+
+/**
+ * Sets the color correction render() applies, e.g. TypicalLEDStrip
+ */
+void NeopixelDither::setCorrection(CRGB correction)
+{
+	this->correction = correction;
+}
+
+/**
+ * Writes the 8 bit frame to leds with correction and brightness already
+ * applied; show it uncorrected at full brightness
+ */
+void NeopixelDither::render(CRGB *leds, uint8_t brightness)
+{
+	uint32_t scale[3];
+	const uint16_t *in = &pixels[0].r;
+	uint8_t *out = leds[0].raw;
+	uint8_t c = 0;
+
+	// correction and brightness fused per channel, 0-65536
+	for(uint8_t i=0; i<3; i++)
+	{
+		scale[i] = ((uint32_t)correction.raw[i] + 1) * ((uint32_t)brightness + 1);
+	}
+
+	for(uint16_t i=0; i<numLeds * 3; i++)
+	{
+		uint16_t value = ((uint32_t)in[i] * scale[c]) >> 16;
+		if( ++c == 3 )
+		{
+			c = 0;
+		}
+		uint16_t sum = (value & 0xFF) + error[i];
+		uint8_t channel = value >> 8;
+		if( sum > 0xFF && channel < 255 )
+		{
+			channel++;
+		}
+		out[i] = channel;
+		error[i] = sum;
+	}
+}
+
+/**
+ * Returns the 16 bit pixels for effects that render into them directly
+ */
+CRGB16 *NeopixelDither::getPixels()
+{
+	return pixels;
+}
+
+/**
+ * Returns the number of LEDs the buffer holds
+ */
+uint16_t NeopixelDither::getNumLeds()
+{
+	return numLeds;
+}
+
+////////////////////////////////////////
+// BEGIN PRIVATE FUNCTIONS
+////////////////////////////////////////
+
+/**
+ * Scales an 8 bit channel by a 16 bit level into 8.8 fixed point, so a
+ * channel at level 65535 is exactly its 8 bit value
+ */
+uint16_t NeopixelDither::expand(uint8_t channel, uint16_t level)
+{
+	return ((uint32_t)channel * ((uint32_t)level + 1)) >> 8;
+}
@@ -0,0 +1,57 @@
+/*
+ * NeopixelDither.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELDITHER_H_
+#define NEOPIXELDITHER_H_
+
+#include <Arduino.h>
+#include <FastLed.h>
+
+/**
+ * One pixel at 16 bits per channel, 8.8 fixed point
+ */
+struct CRGB16
+{
+	uint16_t r;
+	uint16_t g;
+	uint16_t b;
+};
+
+/**
+ * 16 bit per channel render buffer.  render() applies the strip's color
+ * correction and the global brightness at 16 bits and reduces each
+ * channel to 8 bits, carrying the dropped low byte into the next frame.  A level that falls between two
+ * 8 bit steps is shown as the right mix of both over successive frames,
+ * so slow fades at low brightness ramp smoothly instead of stepping.
+ *
+ * Costs 9 bytes per LED: the 16 bit pixels plus one residual byte per
+ * channel.
+ */
+class NeopixelDither
+{
+public:
+	NeopixelDither();
+	boolean begin(uint16_t numLeds);
+
+	void fill(CRGB color, uint16_t level);
+	void blend(uint16_t index, CRGB color, uint16_t level, uint8_t amount);
+	void setCorrection(CRGB correction);
+	void render(CRGB *leds, uint8_t brightness);
+
+	CRGB16 *getPixels();
+	uint16_t getNumLeds();
+
+protected:
+	uint16_t numLeds;
+	CRGB16 *pixels;
+	uint8_t *error;		// low byte left over from the last frame, per channel
+	CRGB correction;
+
+	static uint16_t expand(uint8_t channel, uint16_t level);
+};
+
+#endif /* NEOPIXELDITHER_H_ */
@@ -0,0 +1,178 @@
+/*
+ * NeopixelFrameQueue.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelFrameQueue.h"
+
+#define NEXT_SLOT(i)	(((i) + 1 == FRAME_QUEUE_DEPTH) ? 0 : (i) + 1)
+
+/**
+ * Constructor
+ */
+NeopixelFrameQueue::NeopixelFrameQueue()
+{
+	numLeds = 0;
+	for(uint8_t i=0; i<FRAME_QUEUE_DEPTH; i++)
+	{
+		frames[i] = 0;
+	}
+	head = 0;
+	tail = 0;
+	stalled = false;
+	resetStats();
+}
+
+/**
+ * Allocates the frame buffers.
+ *
+ * Returns false if memory could not be allocated
+ */
+boolean NeopixelFrameQueue::begin(uint16_t numLeds)
+{
+	this->numLeds = numLeds;
+	for(uint8_t i=0; i<FRAME_QUEUE_DEPTH; i++)
+	{
+		frames[i] = (CRGB *) malloc(sizeof(CRGB) * numLeds);
+		if( frames[i] == 0 )
+		{
+			return false;
+		}
+	}
+	head = 0;
+	tail = 0;
+	return true;
+}
+
+/**
+ * Returns the buffer to render the next frame into, or 0 if every
+ * buffer is queued or being transmitted.  Retrying for the same frame
+ * counts as one stall.
+ */
+CRGB *NeopixelFrameQueue::acquire()
+{
+	uint8_t h = head;
+	if( NEXT_SLOT(h) == __atomic_load_n(&tail, __ATOMIC_ACQUIRE) )
+	{
+		if( stalled == false )
+		{
+			stalls++;
+			stalled = true;
+		}
+		return 0;
+	}
+	stalled = false;
+	return frames[h];
+}
+
+/**
+ * Hands the buffer returned by acquire() to the output side, with the
+ * brightness to show it at and whether its colors are already corrected
+ */
+void NeopixelFrameQueue::publish(uint8_t b, boolean c)
+{
+	uint8_t h = head;
+	brightness[h] = b;
+	corrected[h] = c;
+	published[h] = micros();
+	__atomic_store_n(&head, NEXT_SLOT(h), __ATOMIC_RELEASE);
+}
+
+/**
+ * Returns the oldest queued frame, or 0 if the queue is empty
+ */
+CRGB *NeopixelFrameQueue::peek()
+{
+	uint8_t t = tail;
+	if( t == __atomic_load_n(&head, __ATOMIC_ACQUIRE) )
+	{
+		return 0;
+	}
+	return frames[t];
+}
+
+/**
+ * Returns the brightness the frame returned by peek() was rendered at
+ */
+uint8_t NeopixelFrameQueue::getBrightness()
+{
+	return brightness[tail];
+}
+
+/**
+ * Returns true if the frame returned by peek() already has the strip's
+ * color correction applied
+ */
+boolean NeopixelFrameQueue::isCorrected()
+{
+	return corrected[tail];
+}
+
+/**
+ * Returns the frame returned by peek() to the pool once transmitted
+ */
+void NeopixelFrameQueue::release()
+{
+	uint8_t t = tail;
+	uint32_t elapsed = micros() - published[t];
+	latency += elapsed;
+	if( elapsed > maxLatency )
+	{
+		maxLatency = elapsed;
+	}
+	frameCount++;
+	__atomic_store_n(&tail, NEXT_SLOT(t), __ATOMIC_RELEASE);
+}
+
+/**
+ * Returns the length of each frame
+ */
+uint16_t NeopixelFrameQueue::getNumLeds()
+{
+	return numLeds;
+}
+
+/**
+ * Returns the number of frames transmitted since resetStats()
+ */
+uint32_t NeopixelFrameQueue::getFrames()
+{
+	return frameCount;
+}
+
+/**
+ * Returns how many frames found the queue full and had to wait
+ */
+uint32_t NeopixelFrameQueue::getStalls()
+{
+	return stalls;
+}
+
+/**
+ * Returns the total publish to release time of all transmitted frames
+ */
+uint32_t NeopixelFrameQueue::getLatencyMicros()
+{
+	return latency;
+}
+
+/**
+ * Returns the worst publish to release time seen
+ */
+uint32_t NeopixelFrameQueue::getMaxLatencyMicros()
+{
+	return maxLatency;
+}
+
+/**
+ * Clears the statistics.  Only call while both sides are idle.
+ */
+void NeopixelFrameQueue::resetStats()
+{
+	frameCount = 0;
+	stalls = 0;
+	latency = 0;
+	maxLatency = 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * NeopixelFrameQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELFRAMEQUEUE_H_
+#define NEOPIXELFRAMEQUEUE_H_
+
+#include <Arduino.h>
+#include <FastLed.h>
+
+// Frame buffers in the pool; one less than this can be queued at once
+#ifndef FRAME_QUEUE_DEPTH
+#define FRAME_QUEUE_DEPTH	3
+#endif
+
+/**
+ * Lock free single producer / single consumer queue of frame buffers.
+ * The render side acquires a free buffer, fills it and publishes it;
+ * the output side peeks the oldest frame, transmits it and releases it.
+ * acquire() returning 0 is the back-pressure signal: the renderer is
+ * ahead of the wire and must wait (or drop the frame).
+ *
+ * Only the producer writes head and only the consumer writes tail, so
+ * acquire/release ordering on those two indexes is all the
+ * synchronization needed, on one core or two.
+ */
+class NeopixelFrameQueue
+{
+public:
+	NeopixelFrameQueue();
+	boolean begin(uint16_t numLeds);
+
+	// producer side
+	CRGB *acquire();
+	void publish(uint8_t brightness, boolean corrected);
+
+	// consumer side
+	CRGB *peek();
+	uint8_t getBrightness();
+	boolean isCorrected();
+	void release();
+
+	uint16_t getNumLeds();
+	uint32_t getFrames();
+	uint32_t getStalls();
+	uint32_t getLatencyMicros();
+	uint32_t getMaxLatencyMicros();
+	void resetStats();
+
+protected:
+	uint16_t numLeds;
+	CRGB *frames[FRAME_QUEUE_DEPTH];
+	uint8_t brightness[FRAME_QUEUE_DEPTH];
+	boolean corrected[FRAME_QUEUE_DEPTH];	// color correction already applied
+	uint32_t published[FRAME_QUEUE_DEPTH];	// micros() when queued
+
+	uint8_t head;	// written by the producer only
+	uint8_t tail;	// written by the consumer only
+	boolean stalled;	// producer already counted a stall for this frame
+
+	uint32_t frameCount;
+	uint32_t stalls;
+	uint32_t latency;
+	uint32_t maxLatency;
+};
+
+#endif /* NEOPIXELFRAMEQUEUE_H_ */
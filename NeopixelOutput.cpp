@@ -0,0 +1,219 @@
+/*
+ * NeopixelOutput.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelOutput.h"
+
+/**
+ * Constructor
+ */
+NeopixelOutput::NeopixelOutput()
+{
+	numLeds = 0;
+	order = WIRE_RGB;
+	bytesPerPixel = 3;
+	offset[0] = 0;
+	offset[1] = 1;
+	offset[2] = 2;
+	shadow = 0;
+	wire = 0;
+	driver = 0;
+	correction = TypicalLEDStrip;
+	brightness = 255;
+	rebuild = true;
+	computeScale();
+}
+
+/**
+ * Allocates the wire and shadow buffers.  Calling again frees the
+ * previous buffers first.
+ *
+ * @order - WIRE_xxx byte order of the strip
+ */
+boolean NeopixelOutput::begin(uint16_t numLeds, uint8_t order)
+{
+	free(shadow);
+	free(wire);
+
+	this->numLeds = 0;
+	this->order = order;
+	bytesPerPixel = (order == WIRE_RGBW || order == WIRE_GRBW) ? 4 : 3;
+	if( order == WIRE_GRB || order == WIRE_GRBW )
+	{
+		offset[0] = 1;
+		offset[1] = 0;
+	}
+	else
+	{
+		offset[0] = 0;
+		offset[1] = 1;
+	}
+	offset[2] = 2;
+
+	shadow = (CRGB *) malloc(sizeof(CRGB) * numLeds);
+	wire = (uint8_t *) malloc(bytesPerPixel * numLeds);
+	if( shadow == 0 || wire == 0 )
+	{
+		free(shadow);
+		free(wire);
+		shadow = 0;
+		wire = 0;
+		return false;
+	}
+
+	memset(wire, 0, bytesPerPixel * numLeds);
+	this->numLeds = numLeds;
+	rebuild = true;
+
+	return true;
+}
+
+/**
+ * Sets the color correction applied on the wire, e.g. TypicalLEDStrip
+ */
+void NeopixelOutput::setCorrection(CRGB correction)
+{
+	if( correction != this->correction )
+	{
+		this->correction = correction;
+		computeScale();
+	}
+}
+
+/**
+ * Sets the brightness applied on the wire.  Changing it reconverts the
+ * whole strip on the next update.
+ */
+void NeopixelOutput::setBrightness(uint8_t brightness)
+{
+	if( brightness != this->brightness )
+	{
+		this->brightness = brightness;
+		computeScale();
+	}
+}
+
+/**
+ * Sets the function that sends the wire buffer to the strip
+ */
+void NeopixelOutput::setDriver(OutputDriver driver)
+{
+	this->driver = driver;
+}
+
+/**
+ * Brings the wire buffer up to date with leds.  Pixels equal to the
+ * last frame are skipped; the rest are scaled, corrected and reordered
+ * in one pass.
+ *
+ * Returns the number of pixels converted
+ */
+uint16_t NeopixelOutput::update(const CRGB *leds)
+{
+	uint16_t converted = 0;
+	uint8_t *out = wire;
+
+	for(uint16_t i=0; i<numLeds; i++, out += bytesPerPixel)
+	{
+		CRGB c = leds[i];
+		if( rebuild == false && c == shadow[i] )
+		{
+			continue;
+		}
+		shadow[i] = c;
+		converted++;
+
+		uint8_t r = scale8(c.r, scale.r);
+		uint8_t g = scale8(c.g, scale.g);
+		uint8_t b = scale8(c.b, scale.b);
+		if( bytesPerPixel == 4 )
+		{
+			// move the part all three channels share onto the white LED
+			uint8_t w = min(r, min(g, b));
+			r -= w;
+			g -= w;
+			b -= w;
+			out[3] = w;
+		}
+		out[offset[0]] = r;
+		out[offset[1]] = g;
+		out[offset[2]] = b;
+	}
+	rebuild = false;
+
+	return converted;
+}
+
+/**
+ * Hands the wire buffer to the driver.
+ *
+ * Returns false if no driver is set
+ */
+boolean NeopixelOutput::send()
+{
+	if( driver == 0 || wire == 0 )
+	{
+		return false;
+	}
+	driver(wire, bytesPerPixel * numLeds);
+	return true;
+}
+
+/**
+ * Returns the wire ready bytes, bytesPerPixel per LED
+ */
+uint8_t *NeopixelOutput::getBuffer()
+{
+	return wire;
+}
+
+/**
+ * Returns the size of the wire buffer in bytes
+ */
+uint16_t NeopixelOutput::getBufferSize()
+{
+	return bytesPerPixel * numLeds;
+}
+
+/**
+ * Returns the number of LEDs the buffers hold
+ */
+uint16_t NeopixelOutput::getNumLeds()
+{
+	return numLeds;
+}
+
+/**
+ * Returns the WIRE_xxx byte order of the buffer
+ */
+uint8_t NeopixelOutput::getOrder()
+{
+	return order;
+}
+
+/**
+ * Returns true if a driver is set to send the buffer
+ */
+boolean NeopixelOutput::hasDriver()
+{
+	return driver != 0;
+}
+
+////////////////////////////////////////
+// BEGIN PRIVATE FUNCTIONS
+////////////////////////////////////////
+
+/**
+ * Folds correction and brightness into one scale per channel, the same
+ * way FastLED does at show time, and marks the strip for reconversion
+ */
+void NeopixelOutput::computeScale()
+{
+	scale.r = scale8(correction.r, brightness);
+	scale.g = scale8(correction.g, brightness);
+	scale.b = scale8(correction.b, brightness);
+	rebuild = true;
+}
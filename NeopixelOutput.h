@@ -0,0 +1,69 @@
+/*
+ * NeopixelOutput.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELOUTPUT_H_
+#define NEOPIXELOUTPUT_H_
+
+#include <Arduino.h>
+#include <FastLed.h>
+
+// Byte order on the wire
+#define WIRE_RGB	0
+#define WIRE_GRB	1
+#define WIRE_RGBW	2
+#define WIRE_GRBW	3
+
+typedef void (*OutputDriver)(const uint8_t *data, uint16_t length);
+
+/**
+ * Keeps a wire ready copy of the strip: color corrected, scaled to the
+ * global brightness and in the strip's byte order, with the white
+ * channel split out for RGBW strips.  update() converts only pixels that
+ * changed since the last frame in one fused pass, so a frame where one
+ * pixel changed costs one conversion and an unchanged frame costs none.
+ *
+ * A driver (SPI, DMA, ...) receives the bytes exactly as stored.  The
+ * stage only pays off with one: FastLED converts every pixel as it
+ * sends, so NeopixelWrapper::setOutput() refuses a stage without a
+ * driver rather than hand FastLED a buffer it would convert again.
+ */
+class NeopixelOutput
+{
+public:
+	NeopixelOutput();
+	boolean begin(uint16_t numLeds, uint8_t order);
+	void setCorrection(CRGB correction);
+	void setBrightness(uint8_t brightness);
+	void setDriver(OutputDriver driver);
+
+	uint16_t update(const CRGB *leds);
+	boolean send();
+
+	uint8_t *getBuffer();
+	uint16_t getBufferSize();
+	uint16_t getNumLeds();
+	uint8_t getOrder();
+	boolean hasDriver();
+
+protected:
+	uint16_t numLeds;
+	uint8_t order;
+	uint8_t bytesPerPixel;
+	uint8_t offset[3];		// wire position of r, g and b
+	CRGB *shadow;			// last frame converted
+	uint8_t *wire;
+	OutputDriver driver;
+
+	CRGB correction;
+	uint8_t brightness;
+	CRGB scale;				// correction and brightness fused per channel
+	boolean rebuild;		// convert every pixel on the next update
+
+	void computeScale();
+};
+
+#endif /* NEOPIXELOUTPUT_H_ */
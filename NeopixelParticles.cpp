@@ -0,0 +1,190 @@
+/*
+ * NeopixelParticles.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelParticles.h"
+
+/**
+ * Constructor
+ */
+NeopixelParticles::NeopixelParticles()
+{
+	count = 0;
+	lastUpdate = 0;
+	timeScale = 128;
+}
+
+/**
+ * Removes all particles and restarts the motion clock at normal speed
+ */
+void NeopixelParticles::clear()
+{
+	count = 0;
+	lastUpdate = millis();
+	timeScale = 128;
+}
+
+/**
+ * Adds a particle to the pool.
+ *
+ * @pos - starting pixel
+ * @vel - speed in 1/16 pixel per second; sign gives direction
+ * @c - starting color
+ * @fade - amount to fade the color each update (0 = steady)
+ * @frames - number of updates to live (PARTICLE_IMMORTAL = forever)
+ *
+ * Returns the particle index, or -1 if the pool is full
+ */
+int16_t NeopixelParticles::spawn(uint16_t pos, int16_t vel, CRGB c, uint8_t fade, uint16_t frames)
+{
+	if( count >= MAX_PARTICLES )
+	{
+		return -1;
+	}
+
+	position[count] = (uint32_t)pos << 16;
+	velocity[count] = vel;
+	color[count] = c;
+	decay[count] = fade;
+	life[count] = frames;
+
+	return count++;
+}
+
+/**
+ * Advances every particle by the time elapsed since the previous update.
+ * Particles bounce off either end of the strip; particles that have
+ * faded to black or run out of life are dropped from the pool.
+ */
+void NeopixelParticles::update(uint16_t numLeds)
+{
+	uint16_t i;
+	uint32_t now = millis();
+	uint32_t elapsed = now - lastUpdate;
+	lastUpdate = now;
+
+	if( elapsed > 1000 )
+	{
+		elapsed = 1000;
+	}
+	elapsed = (elapsed * timeScale) >> 7;
+
+	// 16.16 position units per velocity unit for this step
+	int32_t scale = (elapsed << (16 - PARTICLE_VELOCITY_SHIFT)) / 1000;
+	int32_t limit = (int32_t)(numLeds - 1) << 16;
+
+	for(i=0; i<count; i++)
+	{
+		int32_t p = (int32_t)position[i] + (int32_t)velocity[i] * scale;
+		if( p < 0 )
+		{
+			p = -p;
+			velocity[i] = -velocity[i];
+		}
+		else if( p > limit )
+		{
+			p = limit - (p - limit);
+			velocity[i] = -velocity[i];
+		}
+		position[i] = constrain(p, 0, limit);
+	}
+
+	for(i=0; i<count; i++)
+	{
+		if( decay[i] )
+		{
+			color[i].nscale8(255 - decay[i]);
+		}
+	}
+
+	// walk backwards so remove() can swap in the last particle
+	i = count;
+	while( i > 0 )
+	{
+		i--;
+		if( (life[i] != PARTICLE_IMMORTAL && --life[i] == 0) || (decay[i] && !color[i]) )
+		{
+			remove(i);
+		}
+	}
+}
+
+/**
+ * Draws every particle into the pixel buffer.
+ *
+ * @mode - PARTICLE_ADD adds colors; PARTICLE_OR keeps the brightest channel
+ * @activeMap - if not null, bit set for every pixel drawn
+ */
+void NeopixelParticles::render(CRGB *leds, uint16_t numLeds, uint8_t mode, uint8_t *activeMap)
+{
+	for(uint16_t i=0; i<count; i++)
+	{
+		uint16_t pixel = position[i] >> 16;
+		if( pixel >= numLeds )
+		{
+			continue;
+		}
+		if( mode == PARTICLE_OR )
+		{
+			leds[pixel] |= color[i];
+		}
+		else
+		{
+			leds[pixel] += color[i];
+		}
+		if( activeMap != 0 )
+		{
+			activeMap[pixel >> 3] |= (1 << (pixel & 0x07));
+		}
+	}
+}
+
+/**
+ * Changes the color of a live particle
+ */
+void NeopixelParticles::setColor(uint16_t index, CRGB c)
+{
+	if( index < count )
+	{
+		color[index] = c;
+	}
+}
+
+/**
+ * Speeds up or slows down motion; 128 is real time, 255 nearly double
+ */
+void NeopixelParticles::setTimeScale(uint8_t scale)
+{
+	timeScale = scale;
+}
+
+/**
+ * Returns the number of live particles
+ */
+uint16_t NeopixelParticles::getCount()
+{
+	return count;
+}
+
+////////////////////////////////////////
+// BEGIN PRIVATE FUNCTIONS
+////////////////////////////////////////
+
+/**
+ * Drops a particle by moving the last one into its slot
+ */
+void NeopixelParticles::remove(uint16_t index)
+{
+	count--;
+	if( index != count )
+	{
+		position[index] = position[count];
+		velocity[index] = velocity[count];
+		color[index] = color[count];
+		decay[index] = decay[count];
+		life[index] = life[count];
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ * NeopixelParticles.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELPARTICLES_H_
+#define NEOPIXELPARTICLES_H_
+
+#include <Arduino.h>
+#include <FastLed.h>
+
+// Pool size; raise on boards with more RAM (-DMAX_PARTICLES=256)
+#ifndef MAX_PARTICLES
+#define MAX_PARTICLES		8
+#endif
+
+// Velocities are expressed in 1/16 pixel per second
+#define PARTICLE_VELOCITY_SHIFT	4
+
+#define PARTICLE_IMMORTAL	0
+
+#define PARTICLE_ADD		0
+#define PARTICLE_OR			1
+
+/**
+ * Fixed capacity pool of moving, fading dots.  Attributes are stored
+ * as parallel arrays so update() can walk each one in a single pass.
+ */
+class NeopixelParticles
+{
+public:
+	NeopixelParticles();
+	void clear();
+	int16_t spawn(uint16_t pos, int16_t vel, CRGB c, uint8_t fade, uint16_t frames);
+	void update(uint16_t numLeds);
+	void render(CRGB *leds, uint16_t numLeds, uint8_t mode, uint8_t *activeMap);
+	void setColor(uint16_t index, CRGB c);
+	void setTimeScale(uint8_t scale);
+	uint16_t getCount();
+
+protected:
+	uint16_t count;
+	uint32_t lastUpdate;
+	uint8_t timeScale;	// 128 = real time
+
+	uint32_t position[MAX_PARTICLES];	// 16.16 fixed point pixel index
+	int16_t velocity[MAX_PARTICLES];	// 1/16 pixel per second
+	CRGB color[MAX_PARTICLES];
+	uint8_t decay[MAX_PARTICLES];		// amount faded each update
+	uint16_t life[MAX_PARTICLES];		// updates remaining; 0 = immortal
+
+	void remove(uint16_t index);
+};
+
+#endif /* NEOPIXELPARTICLES_H_ */
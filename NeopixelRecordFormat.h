@@ -0,0 +1,46 @@
+/*
+ * NeopixelRecordFormat.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Layout of a NeopixelRecorder dump, shared by the recorder and the host
+ * decoder (tools/NeopixelDecode.cpp).  No Arduino dependencies.
+ */
+
+#ifndef NEOPIXELRECORDFORMAT_H_
+#define NEOPIXELRECORDFORMAT_H_
+
+/*
+ * Recording format (all values little endian)
+ *
+ * dump() writes a header followed by the records oldest first:
+ *   "NPR1"  uint16 numLeds
+ *
+ * Each record:
+ *   uint16 record length in bytes, including this field
+ *   uint16 milliseconds since the previous record
+ *   uint8  global brightness
+ *   uint8  flags (RECORD_KEYFRAME = every pixel present,
+ *          RECORD_CORRECTED = color correction already applied)
+ *   spans until the record length is used up:
+ *     uint16 first pixel, uint16 pixel count
+ *     runs until the pixel count is covered:
+ *       uint8 run length (1-255), uint8 r, g, b
+ *
+ * Pixels not covered by a span are unchanged from the previous frame.
+ * When the ring is full the oldest records are dropped, so playback
+ * starts from the first keyframe left in the buffer.
+ */
+
+#define RECORD_MAGIC		"NPR1"
+#define RECORD_MAGIC_BYTES	4
+#define RECORD_FILE_HEADER	6	// magic, numLeds
+#define RECORD_HEADER		6	// length, delta, brightness, flags
+#define RECORD_SPAN_HEADER	4	// first pixel, pixel count
+#define RECORD_RUN			4	// run length, r, g, b
+
+#define RECORD_KEYFRAME		0x01
+#define RECORD_CORRECTED	0x02
+
+#endif /* NEOPIXELRECORDFORMAT_H_ */
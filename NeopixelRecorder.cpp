@@ -0,0 +1,300 @@
+/*
+ * NeopixelRecorder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelRecorder.h"
+
+/**
+ * Constructor
+ */
+NeopixelRecorder::NeopixelRecorder()
+{
+	numLeds = 0;
+	previous = 0;
+	ring = 0;
+	capacity = 0;
+	keyInterval = DEFAULT_KEYFRAME_INTERVAL;
+	reset();
+}
+
+/**
+ * Allocates the previous frame copy and the ring buffer.
+ *
+ * @numLeds - length of the strip being recorded
+ * @capacity - ring buffer size in bytes
+ *
+ * Returns false if memory could not be allocated
+ */
+boolean NeopixelRecorder::begin(uint16_t numLeds, uint16_t capacity)
+{
+	this->numLeds = numLeds;
+	this->capacity = capacity;
+
+	previous = (CRGB *) malloc(sizeof(CRGB) * numLeds);
+	ring = (uint8_t *) malloc(capacity);
+	if( previous == 0 || ring == 0 )
+	{
+		free(previous);
+		free(ring);
+		previous = 0;
+		ring = 0;
+		this->capacity = 0;
+		return false;
+	}
+
+	reset();
+	return true;
+}
+
+/**
+ * Sets how often a full frame is written; shorter intervals lose less
+ * history when the ring wraps at the cost of space
+ */
+void NeopixelRecorder::setKeyframeInterval(uint16_t frames)
+{
+	keyInterval = frames;
+}
+
+/**
+ * Appends a frame.  Only pixels that differ from the previous frame
+ * are stored, except on keyframes.  corrected marks frames that already
+ * carry the strip's color correction.
+ */
+void NeopixelRecorder::record(const CRGB *leds, uint8_t brightness, boolean corrected)
+{
+	if( ring == 0 )
+	{
+		return;
+	}
+
+	uint32_t start = micros();
+
+	boolean key = (frames == 0 || sinceKey >= keyInterval);
+	uint16_t size = RECORD_HEADER + encode(leds, key, false);
+
+	if( size > capacity )
+	{
+		drops++;
+	}
+	else
+	{
+		// drop the oldest records until the new one fits
+		while( capacity - used < size )
+		{
+			uint16_t length = peek16(tail);
+			tail = ((uint32_t) tail + length) % capacity;
+			used -= length;
+		}
+
+		uint32_t now = millis();
+		uint32_t delta = (frames == 0) ? 0 : now - lastTime;
+		lastTime = now;
+
+		put16(size);
+		put16(delta > 0xFFFF ? 0xFFFF : delta);
+		put(brightness);
+		put((key ? RECORD_KEYFRAME : 0) | (corrected ? RECORD_CORRECTED : 0));
+		encode(leds, key, true);
+
+		memcpy(previous, leds, sizeof(CRGB) * numLeds);
+		sinceKey = key ? 1 : sinceKey + 1;
+		frames++;
+		rawBytes += sizeof(CRGB) * numLeds;
+		encodedBytes += size;
+	}
+
+	recordMicros += micros() - start;
+}
+
+/**
+ * Empties the ring and clears the statistics
+ */
+void NeopixelRecorder::reset()
+{
+	head = 0;
+	tail = 0;
+	used = 0;
+	sinceKey = 0;
+	lastTime = 0;
+	frames = 0;
+	drops = 0;
+	rawBytes = 0;
+	encodedBytes = 0;
+	recordMicros = 0;
+}
+
+/**
+ * Writes the recording, oldest record first, in the format described
+ * in NeopixelRecordFormat.h
+ */
+void NeopixelRecorder::dump(Print &out)
+{
+	out.write((const uint8_t *) RECORD_MAGIC, RECORD_MAGIC_BYTES);
+	out.write(numLeds & 0xFF);
+	out.write(numLeds >> 8);
+
+	uint16_t index = tail;
+	for(uint16_t i=0; i<used; i++)
+	{
+		out.write(ring[index]);
+		index = (index + 1 == capacity) ? 0 : index + 1;
+	}
+}
+
+/**
+ * Returns the number of frames stored since reset
+ */
+uint32_t NeopixelRecorder::getFrames()
+{
+	return frames;
+}
+
+/**
+ * Returns the number of frames not stored since reset because their
+ * record was bigger than the whole ring
+ */
+uint32_t NeopixelRecorder::getDrops()
+{
+	return drops;
+}
+
+/**
+ * Returns the bytes the stored frames would take uncompressed
+ */
+uint32_t NeopixelRecorder::getRawBytes()
+{
+	return rawBytes;
+}
+
+/**
+ * Returns the bytes the stored frames took after encoding
+ */
+uint32_t NeopixelRecorder::getEncodedBytes()
+{
+	return encodedBytes;
+}
+
+/**
+ * Returns the total time spent in record()
+ */
+uint32_t NeopixelRecorder::getRecordMicros()
+{
+	return recordMicros;
+}
+
+////////////////////////////////////////
+// BEGIN PRIVATE FUNCTIONS
+////////////////////////////////////////
+
+/**
+ * Emits the spans of a frame.  Called once with write false to size
+ * the record, then again to store it.
+ *
+ * Returns the number of bytes the spans take
+ */
+uint16_t NeopixelRecorder::encode(const CRGB *leds, boolean key, boolean write)
+{
+	uint16_t bytes = 0;
+
+	if( key )
+	{
+		if( write )
+		{
+			put16(0);
+			put16(numLeds);
+		}
+		return RECORD_SPAN_HEADER + encodeRuns(leds, 0, numLeds, write);
+	}
+
+	uint16_t i = 0;
+	while( i < numLeds )
+	{
+		if( leds[i] == previous[i] )
+		{
+			i++;
+			continue;
+		}
+
+		// extend the span across short runs of unchanged pixels
+		uint16_t end = i + 1;
+		for(uint16_t j=end; j<numLeds && (j - end) <= RECORD_SPAN_GAP; j++)
+		{
+			if( leds[j] != previous[j] )
+			{
+				end = j + 1;
+			}
+		}
+
+		if( write )
+		{
+			put16(i);
+			put16(end - i);
+		}
+		bytes += RECORD_SPAN_HEADER + encodeRuns(leds, i, end - i, write);
+		i = end;
+	}
+
+	return bytes;
+}
+
+/**
+ * Run length encodes count pixels starting at start
+ */
+uint16_t NeopixelRecorder::encodeRuns(const CRGB *leds, uint16_t start, uint16_t count, boolean write)
+{
+	uint16_t bytes = 0;
+	uint16_t i = start;
+	uint16_t last = start + count;
+
+	while( i < last )
+	{
+		CRGB color = leds[i];
+		uint8_t run = 1;
+		while( i + run < last && run < 255 && leds[i + run] == color )
+		{
+			run++;
+		}
+		if( write )
+		{
+			put(run);
+			put(color.r);
+			put(color.g);
+			put(color.b);
+		}
+		bytes += RECORD_RUN;
+		i += run;
+	}
+
+	return bytes;
+}
+
+/**
+ * Appends a byte at the head of the ring
+ */
+void NeopixelRecorder::put(uint8_t b)
+{
+	ring[head] = b;
+	head = (head + 1 == capacity) ? 0 : head + 1;
+	used++;
+}
+
+/**
+ * Appends a little endian word at the head of the ring
+ */
+void NeopixelRecorder::put16(uint16_t w)
+{
+	put(w & 0xFF);
+	put(w >> 8);
+}
+
+/**
+ * Reads a little endian word from the ring
+ */
+uint16_t NeopixelRecorder::peek16(uint16_t index)
+{
+	uint16_t next = (index + 1 == capacity) ? 0 : index + 1;
+	return ring[index] | (ring[next] << 8);
+}
@@ -0,0 +1,67 @@
+/*
+ * NeopixelRecorder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELRECORDER_H_
+#define NEOPIXELRECORDER_H_
+
+#include <Arduino.h>
+#include <FastLed.h>
+#include "NeopixelRecordFormat.h"
+
+#define DEFAULT_KEYFRAME_INTERVAL	64
+
+// Unchanged pixels tolerated inside a span before starting a new one
+#define RECORD_SPAN_GAP		2
+
+/**
+ * Records frames sent to the strip as delta/RLE records in a bounded
+ * ring buffer, in the format described in NeopixelRecordFormat.h.
+ * Attach with NeopixelWrapper::setRecorder().
+ */
+class NeopixelRecorder
+{
+public:
+	NeopixelRecorder();
+	boolean begin(uint16_t numLeds, uint16_t capacity);
+	void setKeyframeInterval(uint16_t frames);
+	void record(const CRGB *leds, uint8_t brightness, boolean corrected);
+	void reset();
+	void dump(Print &out);
+
+	uint32_t getFrames();
+	uint32_t getDrops();
+	uint32_t getRawBytes();
+	uint32_t getEncodedBytes();
+	uint32_t getRecordMicros();
+
+protected:
+	uint16_t numLeds;
+	CRGB *previous;		// last recorded frame
+	uint8_t *ring;
+	uint16_t capacity;
+	uint16_t head;		// next byte written
+	uint16_t tail;		// first byte of the oldest record
+	uint16_t used;
+
+	uint16_t keyInterval;
+	uint16_t sinceKey;
+	uint32_t lastTime;
+
+	uint32_t frames;
+	uint32_t drops;		// frames too big for the ring
+	uint32_t rawBytes;
+	uint32_t encodedBytes;
+	uint32_t recordMicros;
+
+	uint16_t encode(const CRGB *leds, boolean key, boolean write);
+	uint16_t encodeRuns(const CRGB *leds, uint16_t start, uint16_t count, boolean write);
+	void put(uint8_t b);
+	void put16(uint16_t w);
+	uint16_t peek16(uint16_t index);
+};
+
+#endif /* NEOPIXELRECORDER_H_ */
@@ -0,0 +1,224 @@
+/*
+ * NeopixelSequencer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelSequencer.h"
+
+/**
+ * Constructor
+ */
+NeopixelSequencer::NeopixelSequencer()
+{
+	wrapper = 0;
+	cues = 0;
+	count = 0;
+	origin = 0;
+}
+
+/**
+ * Sets the show to play.
+ *
+ * @cues - cues sorted by start time; must stay valid while playing
+ */
+void NeopixelSequencer::begin(NeopixelWrapper *wrapper, const Cue *cues, uint8_t count)
+{
+	this->wrapper = wrapper;
+	this->cues = cues;
+	this->count = count;
+}
+
+/**
+ * Makes now timeline position 0
+ */
+void NeopixelSequencer::start()
+{
+	origin = millis();
+}
+
+/**
+ * Re-aligns the timeline so now is the given position, e.g. the
+ * playback position reported by an audio player or another controller.
+ * The cue already playing keeps its end time; later cues follow the
+ * new alignment.
+ */
+void NeopixelSequencer::sync(uint32_t position)
+{
+	origin = millis() - position;
+}
+
+/**
+ * Returns the current timeline position in ms
+ */
+uint32_t NeopixelSequencer::getPosition()
+{
+	return millis() - origin;
+}
+
+/**
+ * Plays every cue whose slot has not already passed.  Call start() or
+ * sync() first.
+ *
+ * Returns false if a command arrived before the show finished
+ */
+boolean NeopixelSequencer::run()
+{
+	if( wrapper == 0 )
+	{
+		return false;
+	}
+
+	uint8_t prepared = count;	// cue already set up ahead of its start
+	for(uint8_t i=0; i<count; i++)
+	{
+		const Cue &cue = cues[i];
+
+		// running late: skip cues that should already be over
+		if( (int32_t)(getPosition() - stopTime(i)) >= 0 )
+		{
+			continue;
+		}
+
+		if( prepared != i )
+		{
+			prepare(i);
+		}
+
+		int32_t wait = (int32_t)(cue.start - getPosition());
+		if( wait > 0 && commandDelay(wait) )
+		{
+			wrapper->clearDeadline();
+			return false;
+		}
+
+		play(i);
+		if( isCommandAvailable() )
+		{
+			wrapper->clearDeadline();
+			return false;
+		}
+
+		// set the next cue up in the lead time or gap before its start
+		if( i + 1 < count )
+		{
+			prepare(i + 1);
+			prepared = i + 1;
+		}
+	}
+
+	wrapper->clearDeadline();
+	return true;
+}
+
+////////////////////////////////////////
+// BEGIN PRIVATE FUNCTIONS
+////////////////////////////////////////
+
+/**
+ * Returns the timeline position a cue stops at: its end, or
+ * SEQUENCER_LEAD_TIME before the next cue's start if that follows
+ * straight on, leaving time to prepare it
+ */
+uint32_t NeopixelSequencer::stopTime(uint8_t index)
+{
+	const Cue &cue = cues[index];
+	uint32_t end = cue.start + cue.duration;
+
+	if( index + 1 < count )
+	{
+		uint32_t next = cues[index + 1].start;
+		if( (int32_t)(next - end) < SEQUENCER_LEAD_TIME && (int32_t)(next - cue.start) > SEQUENCER_LEAD_TIME )
+		{
+			end = next - SEQUENCER_LEAD_TIME;
+		}
+	}
+	return end;
+}
+
+/**
+ * Does everything a cue needs before its start time so that only the
+ * effect itself is left to do at the start: pushes its parameters,
+ * fixes its stop on the timeline and sets up the particle pool and
+ * sparse fade map.
+ */
+void NeopixelSequencer::prepare(uint8_t index)
+{
+	wrapper->setParams(cues[index].params);
+	wrapper->setDeadline(origin + stopTime(index));
+	wrapper->prepareEffect();
+}
+
+/**
+ * Runs the cue's effect until its stop time.  Effects that finish
+ * sooner (fill, wipe, fade, lightning) hold their last frame until then.
+ * A fade in lasts at most until the cue stops.
+ */
+void NeopixelSequencer::play(uint8_t index)
+{
+	const Cue &cue = cues[index];
+	const EffectParams &p = cue.params;
+	boolean clearAfter = (cue.options & CUE_CLEAR_AFTER) != 0;
+	boolean clearEnd = (cue.options & CUE_CLEAR_END) != 0;
+
+	// a cue shorter than its fade must not hand the rest to the next
+	wrapper->setTransition(cue.transition == TRANSITION_FADE ? cue.transitionTime : 0);
+
+	switch( cue.effect )
+	{
+	case EFFECT_FILL:
+		wrapper->fill(p.color1, true);
+		break;
+	case EFFECT_PATTERN:
+		wrapper->pattern(0, cue.pattern, cue.direction, p.color1, p.color2, p.onTime, p.offTime);
+		break;
+	case EFFECT_MIDDLE:
+		wrapper->middle(0, cue.direction, p.color1, p.color2, p.onTime, p.offTime, false, true);
+		break;
+	case EFFECT_RANDOM_FLASH:
+		wrapper->randomFlash(0, p.onTime, p.offTime, p.color1, p.color2);
+		break;
+	case EFFECT_STROBE:
+		wrapper->strobe(0, p.color1, p.color2, p.onTime, p.offTime);
+		break;
+	case EFFECT_RAINBOW:
+		wrapper->rainbow(0, p.intensity, p.color1);
+		break;
+	case EFFECT_RAINBOW_FADE:
+		wrapper->rainbowFade(0);
+		break;
+	case EFFECT_CONFETTI:
+		wrapper->confetti(0, p.color1, p.intensity);
+		break;
+	case EFFECT_CYLON:
+		wrapper->cylon(0, p.color1);
+		break;
+	case EFFECT_BPM:
+		wrapper->bpm(0);
+		break;
+	case EFFECT_JUGGLE:
+		wrapper->juggle(0);
+		break;
+	case EFFECT_WIPE:
+		wrapper->wipe(cue.pattern, cue.direction, p.color1, p.color2, p.onTime, p.offTime, clearAfter, clearEnd);
+		break;
+	case EFFECT_BOUNCE:
+		wrapper->bounce(0, cue.pattern, cue.direction, p.color1, p.color2, p.onTime, p.offTime, cue.holdTime, clearAfter, clearEnd);
+		break;
+	case EFFECT_FADE:
+		wrapper->fade(cue.direction, p.intensity, p.onTime, p.color1);
+		break;
+	case EFFECT_LIGHTNING:
+		wrapper->lightning(p.color1, p.color2);
+		break;
+	}
+
+	// holding re-shows the last frame while the fade in is still going
+	int32_t left = (int32_t)(stopTime(index) - getPosition());
+	if( left > 0 && isCommandAvailable() == false )
+	{
+		wrapper->hold(left);
+	}
+	wrapper->setTransition(0);
+}
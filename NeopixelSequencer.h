@@ -0,0 +1,88 @@
+/*
+ * NeopixelSequencer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELSEQUENCER_H_
+#define NEOPIXELSEQUENCER_H_
+
+#include "NeopixelWrapper.h"
+
+#define EFFECT_FILL			0
+#define EFFECT_PATTERN		1
+#define EFFECT_MIDDLE		2
+#define EFFECT_RANDOM_FLASH	3
+#define EFFECT_STROBE		4
+#define EFFECT_RAINBOW		5
+#define EFFECT_RAINBOW_FADE	6
+#define EFFECT_CONFETTI		7
+#define EFFECT_CYLON		8
+#define EFFECT_BPM			9
+#define EFFECT_JUGGLE		10
+#define EFFECT_WIPE			11
+#define EFFECT_BOUNCE		12
+#define EFFECT_FADE			13
+#define EFFECT_LIGHTNING	14
+
+#define TRANSITION_CUT		0
+#define TRANSITION_FADE		1
+
+// Cue options for wipe and bounce
+#define CUE_CLEAR_AFTER		0x01
+#define CUE_CLEAR_END		0x02
+
+// ms a cue is cut short when the next follows straight on, so the next
+// one can be prepared before its start
+#ifndef SEQUENCER_LEAD_TIME
+#define SEQUENCER_LEAD_TIME	2
+#endif
+
+/**
+ * One entry in a show.  Times are measured from the start of the
+ * timeline, not from the end of the previous cue, so late cues never
+ * push the rest of the show back.
+ */
+struct Cue
+{
+	uint32_t start;			// ms from timeline start
+	uint32_t duration;		// ms
+	uint8_t effect;			// EFFECT_xxx
+	uint8_t pattern;		// bit pattern for EFFECT_PATTERN
+	uint8_t direction;		// LEFT/RIGHT, IN/OUT, UP/DOWN for fade
+	uint8_t transition;		// TRANSITION_xxx
+	uint16_t transitionTime;	// ms to fade in over
+	EffectParams params;	// fade: intensity is the step, onTime the step time
+	uint8_t options;		// CUE_xxx for wipe and bounce
+	uint16_t holdTime;		// ms bounce pauses at each end
+};
+
+/**
+ * Plays a list of cues against one monotonic clock.  Each cue is
+ * prepared (parameters, deadline, particle and sparse fade setup) before
+ * its start time, so at the start only the effect call is left, and the
+ * clock can be re-aligned to an external timebase with sync().
+ */
+class NeopixelSequencer
+{
+public:
+	NeopixelSequencer();
+	void begin(NeopixelWrapper *wrapper, const Cue *cues, uint8_t count);
+	void start();
+	void sync(uint32_t position);
+	uint32_t getPosition();
+	boolean run();
+
+protected:
+	NeopixelWrapper *wrapper;
+	const Cue *cues;
+	uint8_t count;
+	uint32_t origin;		// millis() at timeline position 0
+
+	uint32_t stopTime(uint8_t index);
+	void prepare(uint8_t index);
+	void play(uint8_t index);
+};
+
+#endif /* NEOPIXELSEQUENCER_H_ */
@@ -0,0 +1,47 @@
+/*
+ * NeopixelSpan.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#include "NeopixelSpan.h"
+
+/**
+ * Sets count pixels to color
+ */
+void spanFill(CRGB *dst, uint16_t count, CRGB color)
+{
+	if( count == 0 )
+	{
+		return;
+	}
+	dst[0] = color;
+	spanRepeat(dst, count, dst, 1);
+}
+
+/**
+ * Fills count pixels with repeated copies of tile.  tile may point at
+ * dst itself, in which case the first tileLength pixels are the tile.
+ */
+void spanRepeat(CRGB *dst, uint16_t count, const CRGB *tile, uint16_t tileLength)
+{
+	if( count == 0 || tileLength == 0 )
+	{
+		return;
+	}
+
+	uint16_t done = (tileLength < count) ? tileLength : count;
+	if( tile != dst )
+	{
+		memcpy(dst, tile, sizeof(CRGB) * done);
+	}
+
+	// double the finished region until the span is full
+	while( done < count )
+	{
+		uint16_t chunk = (done < count - done) ? done : count - done;
+		memcpy(dst + done, dst, sizeof(CRGB) * chunk);
+		done += chunk;
+	}
+}
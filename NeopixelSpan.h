@@ -0,0 +1,24 @@
+/*
+ * NeopixelSpan.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ */
+
+#ifndef NEOPIXELSPAN_H_
+#define NEOPIXELSPAN_H_
+
+#include <Arduino.h>
+#include <FastLed.h>
+
+/*
+ * Bulk pixel writes.  Fills and tiles write the first copy by hand and
+ * then double the written region with memcpy, so the bulk of the work
+ * runs in the C library's word wide copy loop instead of one CRGB store
+ * per pixel.
+ */
+
+void spanFill(CRGB *dst, uint16_t count, CRGB color);
+void spanRepeat(CRGB *dst, uint16_t count, const CRGB *tile, uint16_t tileLength);
+
+#endif /* NEOPIXELSPAN_H_ */
@@ -13,29 +13,71 @@
 NeopixelWrapper::NeopixelWrapper()
 {
 	leds = 0;
+	stripLength = 0;
+	activeMap = 0;
+	particles = 0;
+	audio = 0;
+	recorder = 0;
+	pipeline = 0;
+	output = 0;
+	dither = 0;
+	dithering = false;
 	intensity = 200;
 	gHue = 0;
 	sparkleCount = 0;
-	frameWaitTime = 1000/DEFAULT_FPS;
+	targetFps = DEFAULT_FPS;
+	framePeriod = 1000000UL/DEFAULT_FPS;
+	frameStart = 0;
+	frameCost = 0;
+	nominalFrames = 256;
+	paramSequence = 0;
+	deadline = 0;
+	hasDeadline = false;
+	transitionStart = 0;
+	transitionLength = 0;
+	prepared = false;
+	liveParams.color1 = WHITE;
+	liveParams.color2 = BLACK;
+	liveParams.onTime = 0;
+	liveParams.offTime = 0;
+	liveParams.intensity = 0;
+	liveParams.speed = DEFAULT_SPEED;
+	params = liveParams;
 	gHueUpdateTime = 20;
+	lastHueUpdate = 0;
+	fadePseudotime = 0;
+	fadeLastMillis = 0;
+	fadeHue16 = 0;
 }
 
 /**
- * Returns frames per second
- *
+ * Returns the frame rate effects are actually running at; lower than
+ * requested when the strip or the render cost can't keep up
  */
 uint8_t NeopixelWrapper::getFramesPerSecond()
 {
-	return frameWaitTime*1000;
+	return 1000000UL/framePeriod;
 }
 
 /**
  * Changes the amount of times per second functions are
- * updated.
+ * updated.  This is an upper limit; see frameDelay().
  */
 void NeopixelWrapper::setFramesPerSecond(uint8_t fps)
 {
-	frameWaitTime = 1000/fps;
+	if( fps > 0 )
+	{
+		targetFps = fps;
+	}
+}
+
+/**
+ * Returns the fastest rate the strip can physically be refreshed at,
+ * set by the time to clock every pixel out on the wire
+ */
+uint16_t NeopixelWrapper::getMaxFramesPerSecond()
+{
+	return 1000000UL/wireMicros();
 }
 
 /**
@@ -73,17 +115,286 @@ void NeopixelWrapper::setIntensity(uint8_t i)
 	FastLED.setBrightness(intensity);
 }
 
+/**
+ * Enables or disables sparse fading.  When enabled, confetti, cylon and
+ * juggle track which pixels are lit and only fade those; output is
+ * identical to fading the whole strip.  Call after initialize(); the
+ * bitmap is sized to the strip.
+ *
+ * Returns false if the strip is not initialized or the bitmap could not
+ * be allocated
+ */
+boolean NeopixelWrapper::setSparseFade(boolean enable)
+{
+	if( activeMap != 0 )
+	{
+		free(activeMap);
+		activeMap = 0;
+	}
+	if( enable )
+	{
+		if( leds == 0 )
+		{
+			return false;
+		}
+		activeMap = (uint8_t *) malloc((stripLength + 7) / 8);
+		if( activeMap == 0 )
+		{
+			return false;
+		}
+		markAllActive();
+	}
+	return true;
+}
+
+/**
+ * Attaches a particle pool.  confetti, cylon and juggle then move their
+ * dots with it, at a speed that does not depend on the frame rate; pass
+ * 0 to have them draw straight into the strip instead.  Only change this
+ * between effects.
+ */
+void NeopixelWrapper::setParticles(NeopixelParticles *p)
+{
+	particles = p;
+}
+
+/**
+ * Attaches an audio analyzer.  bpm, juggle and confetti take their tempo,
+ * brightness and color from it; pass 0 to go back to fixed settings.
+ */
+void NeopixelWrapper::setAudio(NeopixelAudio *a)
+{
+	audio = a;
+}
+
+/**
+ * Attaches a frame recorder; every frame shown is passed to it.
+ * Pass 0 to stop recording.
+ */
+void NeopixelWrapper::setRecorder(NeopixelRecorder *r)
+{
+	recorder = r;
+}
+
+/**
+ * Switches to pipelined output.  Effects render into the wrapper's buffer
+ * and queue a copy; another core or thread calls transmit() to send the
+ * queued frames.  Pass 0 to go back to showing frames directly; only
+ * change this while the output side is not inside transmit().
+ *
+ * Returns false, leaving output as it was, if the queue's frames are not
+ * the length of the strip
+ */
+boolean NeopixelWrapper::setPipeline(NeopixelFrameQueue *queue)
+{
+	if( queue != 0 && (leds == 0 || queue->getNumLeds() != stripLength) )
+	{
+		return false;
+	}
+	pipeline = queue;
+	if( pipeline == 0 && leds != 0 )
+	{
+		FastLED[0].setLeds(leds, stripLength);
+	}
+	return true;
+}
+
+/**
+ * Routes frames through a wire format output stage, which applies the
+ * strip's color correction and brightness itself, only converts pixels
+ * that changed and hands the result straight to its driver; FastLED no
+ * longer touches the frame.  Set the driver before calling this.  Pass
+ * 0 to go back to FastLED doing the conversion on every show.
+ *
+ * Returns false, leaving output as it was, if the stage is not the
+ * length of the strip or has no driver.  FastLED converts every pixel
+ * as it sends, so giving it the stage's buffer would only add a pass.
+ */
+boolean NeopixelWrapper::setOutput(NeopixelOutput *out)
+{
+	if( out != 0 )
+	{
+		if( leds == 0 || out->getNumLeds() != stripLength || out->hasDriver() == false )
+		{
+			return false;
+		}
+		out->setCorrection(DEFAULT_CORRECTION);
+	}
+
+	output = out;
+	return true;
+}
+
+/**
+ * Attaches a 16 bit render buffer with as many LEDs as the strip.  fade
+ * and rainbowFade then render into it and dither down to 8 bits each
+ * frame, color correction included, and those frames are shown without
+ * correcting them again; pass 0 to go back to 8 bit rendering.
+ */
+void NeopixelWrapper::setDither(NeopixelDither *d)
+{
+	if( d != 0 )
+	{
+		d->setCorrection(DEFAULT_CORRECTION);
+	}
+	dither = d;
+}
+
+/**
+ * Sends the oldest queued frame to the strip.  Runs on the output side
+ * of the pipeline.
+ *
+ * Returns false if no frame was waiting
+ */
+boolean NeopixelWrapper::transmit()
+{
+	if( pipeline == 0 )
+	{
+		return false;
+	}
+
+	CRGB *frame = pipeline->peek();
+	if( frame == 0 )
+	{
+		return false;
+	}
+
+	pushFrame(frame, pipeline->getNumLeds(), pipeline->getBrightness(), pipeline->isCorrected());
+	pipeline->release();
+
+	return true;
+}
+
+/**
+ * Replaces the parameters of the running effect.  Safe to call from an
+ * interrupt, from the isCommandAvailable()/commandDelay() callbacks or
+ * from another core; the effect picks up the whole block at its next
+ * frame without restarting.
+ *
+ * Returns false, leaving the block unchanged, if another write was in
+ * progress (an interrupt landing while the effect seeds the block, or a
+ * second core); call again on the next pass.
+ */
+boolean NeopixelWrapper::setParams(const EffectParams &p)
+{
+	if( claimParams() == false )
+	{
+		return false;
+	}
+	liveParams = p;
+	releaseParams();
+	return true;
+}
+
+/**
+ * Copies the parameters most recently set, including those the running
+ * effect was started with.  Never waits, so it is safe from the same
+ * places as setParams().
+ *
+ * Returns false, with p unusable, if a write was in progress; as with
+ * setParams(), call again on the next pass.
+ */
+boolean NeopixelWrapper::getParams(EffectParams &p)
+{
+	return copyParams(p);
+}
+
+/**
+ * Makes the running effect return at the given millis() time, in
+ * addition to returning when a command arrives.  Used by the sequencer
+ * to end cues on time.
+ */
+void NeopixelWrapper::setDeadline(uint32_t when)
+{
+	deadline = when;
+	hasDeadline = true;
+}
+
+/**
+ * Lets effects run until a command arrives again
+ */
+void NeopixelWrapper::clearDeadline()
+{
+	hasDeadline = false;
+}
+
+/**
+ * Ramps brightness up from black to whatever brightness the effect sets,
+ * over the given time, starting with the next frame shown.  Pass 0 to
+ * end a ramp still running.
+ */
+void NeopixelWrapper::setTransition(uint16_t time)
+{
+	transitionStart = millis();
+	transitionLength = time;
+}
+
+/**
+ * Waits like commandDelay(), but while a transition is ramping keeps
+ * showing the current frame at the frame rate, so effects that show a
+ * frame and then wait still fade in smoothly.
+ *
+ * Returns true if a command arrived
+ */
+uint8_t NeopixelWrapper::hold(uint32_t time)
+{
+	uint32_t start = millis();
+	uint32_t step = framePeriod / 1000;
+	if( step == 0 )
+	{
+		step = 1;
+	}
+
+	while( transitionLength > 0 )
+	{
+		uint32_t waited = millis() - start;
+		if( waited >= time )
+		{
+			return false;
+		}
+		if( commandDelay(min(time - waited, step)) )
+		{
+			return true;
+		}
+		showStrip();
+	}
+
+	uint32_t waited = millis() - start;
+	if( waited >= time )
+	{
+		return false;
+	}
+	return commandDelay(time - waited);
+}
+
+/**
+ * Does the setup the particle effects start with, clearing the pool and
+ * marking the whole strip for the sparse fade, ahead of time.  The next
+ * effect then goes straight to its first frame; showing any frame first
+ * cancels the preparation.
+ */
+void NeopixelWrapper::prepareEffect()
+{
+	if( particles != 0 )
+	{
+		particles->clear();
+	}
+	markAllActive();
+	prepared = true;
+}
+
 /**
  * Initializes the library
  */
-boolean NeopixelWrapper::initialize(uint8_t numLeds, uint8_t intensity)
+boolean NeopixelWrapper::initialize(uint16_t numLeds, uint8_t intensity)
 {
 	boolean status = false;
 
 	leds = (CRGB *) malloc(sizeof(CRGB) * numLeds);
 	if (leds != 0)
 	{
-		FastLED.addLeds<DEFAULT_CONTROLLER, DEFAULT_LED_PIN>(leds, numLeds).setCorrection(TypicalLEDStrip);
+		stripLength = numLeds;
+		FastLED.addLeds<DEFAULT_CONTROLLER, DEFAULT_LED_PIN>(leds, numLeds).setCorrection(DEFAULT_CORRECTION);
 		// set master brightness control
 		FastLED.setBrightness(intensity);
 		status = true;
@@ -100,14 +411,10 @@ boolean NeopixelWrapper::initialize(uint8_t numLeds, uint8_t intensity)
  */
 void NeopixelWrapper::fill(CRGB color, uint8_t show)
 {
-	FastLED.showColor( color );
-    for (uint8_t i = 0; i < FastLED.size(); i++)
-    {
-        leds[i] = color;
-    }
+	spanFill(leds, stripLength, color);
     if (show)
     {
-        FastLED.show();
+        showStrip();
     }
 }
 
@@ -118,28 +425,14 @@ void NeopixelWrapper::fill(CRGB color, uint8_t show)
  */
 void NeopixelWrapper::fillPattern(uint8_t pattern, CRGB onColor, CRGB offColor)
 {
-    uint16_t j;
-    int i;
-
-    j = 0;
-
-    for (i = 0; i < FastLED.size(); i++)
+    // build one 8 pixel tile in place, then repeat it down the strip
+    uint8_t tileLength = (stripLength < 8) ? stripLength : 8;
+    for (uint8_t j = 0; j < tileLength; j++)
     {
-        if ((pattern >> j) & 0x01)
-        {
-            leds[i] = onColor;
-        }
-        else
-        {
-            leds[i] = offColor;
-        }
-        j = j + 1;
-        if (j == 8)
-        {
-            j = 0;
-        }
+        leds[j] = ((pattern >> j) & 0x01) ? onColor : offColor;
     }
-    FastLED.show();
+    spanRepeat(leds, stripLength, leds, tileLength);
+    showStrip();
 
 }
 
@@ -152,10 +445,12 @@ void NeopixelWrapper::pattern(uint16_t repeat, uint8_t pattern, uint8_t directio
 
 	i = 0;
 	count = 0;
-	while (isCommandAvailable() == false)
+	startParams(onColor, offColor, onTime, offTime, 0);
+	while (running())
 	{
-		fillPattern(pattern, onColor, offColor);
-		if (commandDelay(onTime))
+		loadParams();
+		fillPattern(pattern, params.color1, params.color2);
+		if (stepDelay(params.onTime))
 			break;
 		if (direction == LEFT)
 		{
@@ -204,28 +499,8 @@ void NeopixelWrapper::pattern(uint16_t repeat, uint8_t pattern, uint8_t directio
  */
 void NeopixelWrapper::wipe(uint8_t pattern, uint8_t direction, CRGB onColor, CRGB offColor, uint32_t onTime, uint32_t offTime, uint8_t clearAfter, uint8_t clearEnd)
 {
-	fill(offColor, true);
-	if( direction == LEFT)
-	{
-		for(uint8_t i=0; i<FastLED.size(); i++)
-		{
-			setWipeColor(onColor, i, onTime, offTime, clearAfter);
-			if(isCommandAvailable()) return;
-		}
-	}
-	else if (direction == RIGHT )
-	{
-		for(uint8_t i=FastLED.size(); i>0; i--)
-		{
-			setWipeColor(onColor, i, onTime, offTime, clearAfter);
-			if(isCommandAvailable()) return;
-		}
-	}
-
-	if( clearEnd )
-	{
-		fill(offColor, true);
-	}
+	startParams(onColor, offColor, onTime, offTime, 0);
+	wipePass(direction, clearAfter, clearEnd);
 }
 
 /**
@@ -235,22 +510,23 @@ void NeopixelWrapper::bounce(uint16_t repeat, uint8_t pattern, uint8_t direction
 {
 	uint16_t count = 0;
 
-	while (isCommandAvailable() == false)
+	startParams(onColor, offColor, onTime, offTime, 0);
+	while (running())
 	{
 		if( direction == LEFT )
 		{
-			wipe(pattern, LEFT, onColor, offColor, onTime, offTime, clearAfter, clearEnd);
-			if( commandDelay(bounceTime) ) return;
-			wipe(pattern, RIGHT, onColor, offColor, onTime, offTime, clearAfter, clearEnd);
-			if(isCommandAvailable()) return;
-			if( commandDelay(bounceTime) ) return;
+			wipePass(LEFT, clearAfter, clearEnd);
+			if( stepDelay(bounceTime) ) return;
+			wipePass(RIGHT, clearAfter, clearEnd);
+			if(!running()) return;
+			if( stepDelay(bounceTime) ) return;
 		}
 		else if (direction == RIGHT )
 		{
-			wipe(pattern, RIGHT, onColor, offColor, onTime, offTime, clearAfter, clearEnd);
-			if( commandDelay(bounceTime) ) return;
-			wipe(pattern, LEFT, onColor, offColor, onTime, offTime, clearAfter, clearEnd);
-			if( commandDelay(bounceTime) ) return;
+			wipePass(RIGHT, clearAfter, clearEnd);
+			if( stepDelay(bounceTime) ) return;
+			wipePass(LEFT, clearAfter, clearEnd);
+			if( stepDelay(bounceTime) ) return;
 		}
 		count++;
 		if( repeat > 0 && count > repeat )
@@ -268,54 +544,59 @@ void NeopixelWrapper::bounce(uint16_t repeat, uint8_t pattern, uint8_t direction
 void NeopixelWrapper::middle(uint16_t repeat, uint8_t direction, CRGB color1, CRGB color2, uint32_t onTime, uint32_t offTime, uint8_t clearAfter, uint8_t clearEnd)
 {
 	uint16_t count = 0;
-	uint8_t numPixels = FastLED.size();
-	uint8_t halfNumPixels = numPixels/2;
+	uint16_t numPixels = stripLength;
+	uint16_t halfNumPixels = numPixels/2;
+	// center pixel(s): the same pixel on odd strips, adjacent pair on even
+	uint16_t lowerCenter = (numPixels-1)/2;
 
+	startParams(color1, color2, onTime, offTime, 0);
 	if(clearEnd)
 	{
 		fill(color2, true);
 	}
-	while (isCommandAvailable() == false)
+	while (running())
 	{
 		if(direction == IN)
 		{
-			for(uint8_t i=0; i<halfNumPixels; i++)
+			for(uint16_t i=0; i<halfNumPixels; i++)
 			{
-				leds[i] = color1;
-				leds[(numPixels-1)-i] = color1;
-				FastLED.show();
-				if( commandDelay(onTime) ) return;
+				loadParams();
+				leds[i] = params.color1;
+				leds[(numPixels-1)-i] = params.color1;
+				showStrip();
+				if( stepDelay(params.onTime) ) return;
 
 				if( clearAfter == true )
 				{
-					leds[i] = color2;
-					leds[(numPixels-1)-i] = color2;
-					FastLED.show();
-					if( commandDelay(offTime) ) return;
+					leds[i] = params.color2;
+					leds[(numPixels-1)-i] = params.color2;
+					showStrip();
+					if( stepDelay(params.offTime) ) return;
 				}
 			}
 		}
 		else if( direction == OUT )
 		{
-			for(uint8_t i=0; i<halfNumPixels+1; i++)
+			for(uint16_t i=0; i<=lowerCenter; i++)
 			{
-				leds[halfNumPixels-i] = color1;
-				leds[halfNumPixels+i] = color1;
-				FastLED.show();
-				if( commandDelay(onTime) ) return;
+				loadParams();
+				leds[lowerCenter-i] = params.color1;
+				leds[halfNumPixels+i] = params.color1;
+				showStrip();
+				if( stepDelay(params.onTime) ) return;
 
 				if( clearAfter == true )
 				{
-					leds[halfNumPixels-i] = color2;
-					leds[halfNumPixels+i] = color2;
-					FastLED.show();
-					if( commandDelay(offTime) ) return;
+					leds[lowerCenter-i] = params.color2;
+					leds[halfNumPixels+i] = params.color2;
+					showStrip();
+					if( stepDelay(params.offTime) ) return;
 				}
 			}
 		}
 		if(clearEnd)
 		{
-			fill(color2, true);
+			fill(params.color2, true);
 		}
 
 		count++;
@@ -332,46 +613,112 @@ void NeopixelWrapper::middle(uint16_t repeat, uint8_t direction, CRGB color1, CR
  */
 void NeopixelWrapper::randomFlash(uint32_t runTime, uint32_t onTime, uint32_t offTime, CRGB onColor, CRGB offColor)
 {
-	uint8_t i;
+	uint16_t i;
 
+	startParams(onColor, offColor, onTime, offTime, 0);
 	fill(offColor, true);
 
-	while (isCommandAvailable() == false)
+	while (running())
 	{
-		i = random(FastLED.size());
-		leds[i] = onColor;
-		FastLED.show();
-		if (commandDelay(onTime)) break;
-		leds[i] = offColor;
-		if (commandDelay(offTime)) break;
+		loadParams();
+		i = random16(stripLength);
+		leds[i] = params.color1;
+		showStrip();
+		if (stepDelay(params.onTime)) break;
+		leds[i] = params.color2;
+		if (stepDelay(params.offTime)) break;
 	}
 
-	fill(offColor, true);
+	fill(params.color2, true);
 
 } // randomFlash
 
 
 /**
- * Fades LEDs up or down with the specified time increment
+ * Fades LEDs up or down with the specified time increment.  color1,
+ * onTime (the time per step) and intensity (the step size) are read live.
  */
 void NeopixelWrapper::fade(uint8_t direction, uint8_t fadeIncrement, uint32_t time, CRGB color)
 {
-	uint8_t i;
+	uint16_t i;
 
-	for(i=0; i<255; i+=fadeIncrement)
+	startParams(color, BLACK, time, 0, fadeIncrement);
+
+	if( startDither() )
 	{
+		// ramp at 16 bits every frame, as fast as the steps would go
+		uint32_t progress = 0;		// fraction done, 0-65535
+		uint32_t remainder = 0;
+		uint32_t last = millis();
+		uint16_t level = (direction == UP) ? 0 : 65535;
+
+		FastLED.setBrightness(255);
+		startFrames();
+		while( running() )
+		{
+			loadParams();
+			uint8_t increment = params.intensity ? params.intensity : 1;
+			uint32_t now = millis();
+			uint32_t elapsed = now - last;
+			last = now;
+			if( elapsed > 100 )
+			{
+				elapsed = 100;
+			}
+
+			// whole fade takes 255/increment steps of onTime each; the
+			// remainder keeps slow fades from losing progress to rounding
+			uint32_t span = 255UL * params.onTime;
+			if( span == 0 )
+			{
+				progress = 65535;
+			}
+			else
+			{
+				remainder += elapsed * increment * 65535UL;
+				progress += remainder / span;
+				remainder %= span;
+				if( progress > 65535 )
+				{
+					progress = 65535;
+				}
+			}
+			level = (direction == DOWN) ? 65535 - progress : progress;
+
+			dither->fill(params.color1, level);
+			showStrip();
+			if( progress == 65535 )
+			{
+				break;
+			}
+			frameDelay();
+		}
+		dithering = false;
+
+		// leave the color in leds at the level reached, as the stepped fade does
+		FastLED.setBrightness(level >> 8);
+		spanFill(leds, stripLength, params.color1);
+		return;
+	}
+
+	for(i=0; i<255; i+=params.intensity)
+	{
+		loadParams();
+		if( params.intensity == 0 )
+		{
+			params.intensity = 1;
+		}
 		if( direction == DOWN )
 		{
-			FastLED.setBrightness(255-i);
+			FastLED.setBrightness(255 - i);
 		}
 		else if( direction == UP)
 		{
 			FastLED.setBrightness(i);
 		}
-		FastLED.showColor(color);
-
-//		fill( color, true );
-		if( commandDelay(time) ) break;
+		spanFill(leds, stripLength, params.color1);
+		showStrip();
+		if( stepDelay(params.onTime) ) break;
 	}
 
 }
@@ -382,26 +729,29 @@ void NeopixelWrapper::fade(uint8_t direction, uint8_t fadeIncrement, uint32_t ti
 void NeopixelWrapper::strobe(uint32_t duration, CRGB onColor, CRGB offColor, uint32_t onTime, uint32_t offTime )
 {
 	FastLED.setBrightness(255);
+	startParams(onColor, offColor, onTime, offTime, 0);
 
 	if( duration > 0)
 	{
 		uint32_t end = millis() + duration;
 		while( millis() < end )
 		{
-			fill(onColor, true);
-			if( commandDelay(onTime) ) break;
-			fill(offColor, true);
-			if( commandDelay(offTime) ) break;
+			loadParams();
+			fill(params.color1, true);
+			if( stepDelay(params.onTime) ) break;
+			fill(params.color2, true);
+			if( stepDelay(params.offTime) ) break;
 		}
 	}
 	else
 	{
-		while( isCommandAvailable() == false )
+		while( running() )
 		{
-			fill(onColor, true);
-			if( commandDelay(onTime) ) break;
-			fill(offColor, true);
-			if( commandDelay(offTime) ) break;
+			loadParams();
+			fill(params.color1, true);
+			if( stepDelay(params.onTime) ) break;
+			fill(params.color2, true);
+			if( stepDelay(params.offTime) ) break;
 		}
 	}
 }
@@ -418,29 +768,31 @@ void NeopixelWrapper::lightning(CRGB onColor, CRGB offColor)
 
 	b = false;
 	FastLED.setBrightness(255);
+	startParams(onColor, offColor, 0, 0, 0);
 
 	count = random(2, 6);
 	for(i=0; i<count; i++)
 	{
+		loadParams();
 		large = random(0,100);
-		fill(onColor, true);
+		fill(params.color1, true);
 		if( large > 40 && b == false)
 		{
-			if( commandDelay(random(100, 350)) ) break;
+			if( stepDelay(random(100, 350)) ) break;
 			b = true;
 		}
 		else
 		{
-			if( commandDelay(random(20, 50)) ) break;
+			if( stepDelay(random(20, 50)) ) break;
 		}
-		fill(offColor, true);
+		fill(params.color2, true);
 		if( large > 40 && b == false )
 		{
-			if( commandDelay(random(200, 500)) ) break;
+			if( stepDelay(random(200, 500)) ) break;
 		}
 		else
 		{
-			if( commandDelay(random(30, 70)) ) break;
+			if( stepDelay(random(30, 70)) ) break;
 		}
 	}
 }
@@ -452,26 +804,26 @@ void NeopixelWrapper::lightning(CRGB onColor, CRGB offColor)
  */
 void NeopixelWrapper::rainbow(uint32_t runTime, uint8_t glitterProbability, CRGB glitterColor)
 {
-    while(isCommandAvailable() == false )
+    startParams(glitterColor, BLACK, 0, 0, glitterProbability);
+    startFrames();
+    while(running() )
     {
+        loadParams();
         // FastLED's built-in rainbow generator
         fill_rainbow(leds, FastLED.size(), gHue, 7);
-        if (glitterProbability > 0)
+        if (params.intensity > 0)
         {
-            if (random8() < glitterProbability)
+            if (random8() < params.intensity)
             {
-                leds[random16(FastLED.size())] += glitterColor;
+                leds[random16(FastLED.size())] += params.color1;
             }
 
         }
-        FastLED.show();
-        FastLED.delay( frameWaitTime );
+        showStrip();
+        frameDelay();
 
-        // do some periodic updates
-        EVERY_N_MILLISECONDS(gHueUpdateTime)
-        {
-            gHue++;
-        } // slowly cycle the "base color" through the rainbow
+        // slowly cycle the "base color" through the rainbow
+        updateHue();
     }
 
 } // end rainbow
@@ -484,27 +836,33 @@ void NeopixelWrapper::rainbow(uint32_t runTime, uint8_t glitterProbability, CRGB
 void NeopixelWrapper::rainbowFade(uint32_t runTime)
 {
 
-    while(isCommandAvailable() == false )
+    startDither();
+    startFrames();
+    while(running() )
     {
-
-        static uint16_t sPseudotime = 0;
-        static uint16_t sLastMillis = 0;
-        static uint16_t sHue16 = 0;
-
+        loadParams();
         uint8_t sat8 = beatsin88(87, 220, 250);
         uint8_t brightdepth = beatsin88(341, 96, 224);
         uint16_t brightnessthetainc16 = beatsin88(203, (25 * 256), (40 * 256));
         uint8_t msmultiplier = beatsin88(147, 23, 60);
 
-        uint16_t hue16 = sHue16; //gHue * 256;
+        uint16_t hue16 = fadeHue16; //gHue * 256;
         uint16_t hueinc16 = beatsin88(113, 1, 3000);
 
         uint16_t ms = millis();
-        uint16_t deltams = ms - sLastMillis;
-        sLastMillis = ms;
-        sPseudotime += deltams * msmultiplier;
-        sHue16 += deltams * beatsin88(400, 5, 9);
-        uint16_t brightnesstheta16 = sPseudotime;
+        uint16_t deltams = ms - fadeLastMillis;
+        fadeLastMillis = ms;
+        deltams = ((uint32_t)deltams * params.speed) >> 7;
+        fadePseudotime += deltams * msmultiplier;
+        fadeHue16 += deltams * beatsin88(400, 5, 9);
+        uint16_t brightnesstheta16 = fadePseudotime;
+
+        // blend 64/256 of the way per frame at DEFAULT_FPS
+        uint16_t blendAmount = (64 * (uint32_t)nominalFrames) >> 8;
+        if (blendAmount > 255)
+        {
+            blendAmount = 255;
+        }
 
         for (uint16_t i = 0; i < (uint16_t) FastLED.size(); i++)
         {
@@ -518,17 +876,29 @@ void NeopixelWrapper::rainbowFade(uint32_t runTime)
             uint8_t bri8 = (uint32_t) (((uint32_t) bri16) * brightdepth) / 65536;
             bri8 += (255 - brightdepth);
 
-            CRGB newcolor = CHSV(hue8, sat8, bri8);
-
             uint16_t pixelnumber = i;
             pixelnumber = (FastLED.size() - 1) - pixelnumber;
 
-            nblend(leds[pixelnumber], newcolor, 64);
+            if (dithering)
+            {
+                // keep the brightness bri8 would have truncated away, and
+                // square it as CHSV squares value, so only quantization
+                // differs from the 8 bit path
+                uint16_t level = (((uint32_t) bri16 * brightdepth) >> 8) + ((255 - brightdepth) << 8);
+                level = scale16(level, level);
+                dither->blend(pixelnumber, CHSV(hue8, sat8, 255), level, blendAmount);
+            }
+            else
+            {
+                CRGB newcolor = CHSV(hue8, sat8, bri8);
+                nblend(leds[pixelnumber], newcolor, blendAmount);
+            }
         }
 
-        FastLED.show();
-        FastLED.delay( frameWaitTime );
+        showStrip();
+        frameDelay();
     }
+    dithering = false;
 
 } // end rainbow fade
 
@@ -544,27 +914,60 @@ void NeopixelWrapper::rainbowFade(uint32_t runTime)
  */
 void NeopixelWrapper::confetti(uint32_t runTime, CRGB color, uint8_t numLeds)
 {
-    while(isCommandAvailable() == false )
+	uint16_t numPixels = FastLED.size();
+	uint16_t sparkTime = 0;
+
+	startParams(color, BLACK, 0, 0, numLeds);
+	startEffect();
+	startFrames();
+    while(running() )
     {
+        loadParams();
         // random colored speckles that blink in and fade smoothly
-        fadeToBlackBy(leds, FastLED.size(), numLeds);
-        int pos = random16(FastLED.size());
-        if (color == (CRGB)RAINBOW)
+        fadeStrip(params.intensity);
+        if (particles != 0)
         {
-            leds[pos] += CHSV(gHue + random8(64), 200, 255);
-            // do some periodic updates
-            EVERY_N_MILLISECONDS(gHueUpdateTime)
-            {
-                gHue++;
-            } // cycle the "base color" through the rainbow
+            particles->update(numPixels);
+        }
+
+        // one speckle per DEFAULT_FPS frame however fast we really run
+        sparkTime += ((uint32_t)nominalFrames * params.speed) >> 7;
+        uint8_t sparks = sparkTime >> 8;
+        sparkTime &= 0xFF;
 
+        if (audio != 0)
+        {
+            // louder music throws more speckles; beats throw a burst
+            audio->update();
+            uint8_t level = audio->getLevel();
+            sparks = sparks * (1 + (level >> 6)) + (audio->getBeat() ? 4 : 0);
+            for (uint8_t s = 0; s < sparks; s++)
+            {
+                spark(random16(numPixels), CHSV(audio->getHue() + random8(64), 200, qadd8(level, 64)));
+            }
+        }
+        else if (params.color1 == (CRGB)RAINBOW)
+        {
+            for (uint8_t s = 0; s < sparks; s++)
+            {
+                spark(random16(numPixels), CHSV(gHue + random8(64), 200, 255));
+            }
+            // cycle the "base color" through the rainbow
+            updateHue();
         }
         else
         {
-            leds[pos] += color;
+            for (uint8_t s = 0; s < sparks; s++)
+            {
+                spark(random16(numPixels), params.color1);
+            }
+        }
+        if (particles != 0)
+        {
+            particles->render(leds, numPixels, PARTICLE_ADD, activeMap);
         }
-        FastLED.show();
-        FastLED.delay( frameWaitTime );
+        showStrip();
+        frameDelay();
 
     }
 
@@ -605,33 +1008,48 @@ void NeopixelWrapper::confetti(uint32_t runTime, CRGB color, uint8_t numLeds)
  */
 void NeopixelWrapper::cylon(uint16_t repeat, CRGB color)
 {
-	uint16_t count = 0;
-	repeat = FastLED.size()*repeat;
+	uint16_t numPixels = FastLED.size();
+	uint32_t start = millis();
 
-    while(isCommandAvailable() == false )
+	// one dot sweeping the strip end to end every three seconds
+	startParams(color, BLACK, 0, 0, 0);
+	startEffect();
+	if (particles != 0)
+	{
+		particles->spawn(0, (numPixels << PARTICLE_VELOCITY_SHIFT)/3, color, 0, PARTICLE_IMMORTAL);
+	}
+	startFrames();
+
+    while(running() )
     {
-        fadeToBlackBy(leds, FastLED.size(), 20);
-        int pos = beatsin16(10, 0, FastLED.size());
-        if (color == (CRGB)RAINBOW)
+        loadParams();
+        fadeStrip(20);
+        CRGB dot = params.color1;
+        if (dot == (CRGB)RAINBOW)
         {
-            leds[pos] += CHSV(gHue, 255, 192);
-            // do some periodic updates
-            EVERY_N_MILLISECONDS(gHueUpdateTime)
-            {
-                // slowly cycle the "base color" through the rainbow
-                gHue++;
-            }
+            dot = CHSV(gHue, 255, 192);
+            // slowly cycle the "base color" through the rainbow
+            updateHue();
+        }
+        if (particles != 0)
+        {
+            particles->setTimeScale(params.speed);
+            particles->update(numPixels);
+            particles->setColor(0, dot);
+            particles->render(leds, numPixels, PARTICLE_ADD, activeMap);
         }
         else
         {
-            leds[pos] += color;
+            // 10 beats per minute is one sweep every three seconds
+            uint16_t pos = beatsin16(((uint16_t)10 * params.speed) >> 7, 0, numPixels);
+            leds[pos] += dot;
+            markActive(pos);
         }
 
-        FastLED.show();
-        FastLED.delay( frameWaitTime );
+        showStrip();
+        frameDelay();
 
-		count++;
-		if( repeat > 0 && count > repeat )
+		if( repeat > 0 && (millis() - start) > (uint32_t)repeat * 3000 )
 		{
 			break;
 		}
@@ -645,24 +1063,38 @@ void NeopixelWrapper::cylon(uint16_t repeat, CRGB color)
  */
 void NeopixelWrapper::bpm(uint32_t runTime)
 {
-    while(isCommandAvailable() == false )
+    startFrames();
+    while(running() )
     {
         // colored stripes pulsing at a defined Beats-Per-Minute (BPM)
-        uint8_t BeatsPerMinute = 62;
-        CRGBPalette16 palette = PartyColors_p;
+        // palette is read straight from flash; no CRGBPalette16 copy on the stack
+        loadParams();
+        uint8_t BeatsPerMinute = ((uint16_t)DEFAULT_AUDIO_BPM * params.speed) >> 7;
+        uint8_t hueOffset = 0;
+        uint8_t level = 255;
+        if (audio != 0)
+        {
+            // pulse at the music's tempo, colored and dimmed by the music
+            audio->update();
+            uint16_t tempo = ((uint16_t)audio->getBeatsPerMinute() * params.speed) >> 7;
+            BeatsPerMinute = (tempo > 255) ? 255 : tempo;
+            hueOffset = audio->getHue();
+            level = qadd8(audio->getLevel(), 32);
+        }
         uint8_t beat = beatsin8(BeatsPerMinute, 64, 255);
         for (int i = 0; i < FastLED.size(); i++)
-        { //9948
-            leds[i] = ColorFromPalette(palette, gHue + (i * 2), beat - gHue + (i * 10));
-        }
-        // do some periodic updates
-        EVERY_N_MILLISECONDS(gHueUpdateTime)
         {
-            gHue++;
-        } // slowly cycle the "base color" through the rainbow
+            leds[i] = ColorFromPalette(PartyColors_p, gHue + hueOffset + (i * 2), beat - gHue + (i * 10));
+            if (level != 255)
+            {
+                leds[i].nscale8_video(level);
+            }
+        }
+        // slowly cycle the "base color" through the rainbow
+        updateHue();
 
-        FastLED.show();
-        FastLED.delay( frameWaitTime );
+        showStrip();
+        frameDelay();
     }
 
 }
@@ -673,19 +1105,70 @@ void NeopixelWrapper::bpm(uint32_t runTime)
  */
 void NeopixelWrapper::juggle(uint32_t runTime)
 {
-    while(isCommandAvailable() == false )
+	uint16_t numPixels = FastLED.size();
+
+    // eight colored dots, weaving in and out of sync with each other
+	startEffect();
+    byte dothue = 0;
+    if (particles != 0)
     {
-        // eight colored dots, weaving in and out of sync with each other
-        fadeToBlackBy(leds, FastLED.size(), 20);
-        byte dothue = 0;
-        for (int i = 0; i < 8; i++)
+        for (uint8_t i = 0; i < 8; i++)
         {
-            leds[beatsin16(i + 7, 0, FastLED.size())] |= CHSV(dothue, 200, 255);
+            // each dot crosses the strip twice every 60/(i+7) seconds
+            int16_t vel = ((int32_t)numPixels * 2 * (i + 7) << PARTICLE_VELOCITY_SHIFT) / 60;
+            particles->spawn(0, vel, CHSV(dothue, 200, 255), 0, PARTICLE_IMMORTAL);
             dothue += 32;
         }
+    }
+	startFrames();
+
+    while(running() )
+    {
+        loadParams();
+        fadeStrip(20);
+        uint16_t scale = params.speed;
+        uint8_t value = 255;
+        dothue = 0;
+        if (audio != 0)
+        {
+            // louder music moves the dots faster and brighter
+            audio->update();
+            uint8_t level = audio->getLevel();
+            scale = ((64 + (level >> 1)) * params.speed) >> 7;
+            if (scale > 255)
+            {
+                scale = 255;
+            }
+            value = qadd8(level, 64);
+            dothue = audio->getHue();
+        }
+        if (particles != 0)
+        {
+            particles->setTimeScale(scale);
+            if (audio != 0)
+            {
+                for (uint8_t i = 0; i < 8; i++)
+                {
+                    particles->setColor(i, CHSV(dothue, 200, value));
+                    dothue += 32;
+                }
+            }
+            particles->update(numPixels);
+            particles->render(leds, numPixels, PARTICLE_OR, activeMap);
+        }
+        else
+        {
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                uint16_t pos = beatsin16(((i + 7) * scale) >> 7, 0, numPixels);
+                leds[pos] |= CHSV(dothue, 200, value);
+                markActive(pos);
+                dothue += 32;
+            }
+        }
 
-        FastLED.show();
-        FastLED.delay( frameWaitTime );
+        showStrip();
+        frameDelay();
     }
 }
 
@@ -693,6 +1176,493 @@ void NeopixelWrapper::juggle(uint32_t runTime)
 // BEGIN PRIVATE FUNCTIONS
 ////////////////////////////////////////
 
+/**
+ * Sends the pixel buffer to the strip.  All effects output through
+ * here so the frame can also be handed to the recorder.
+ */
+void NeopixelWrapper::showStrip()
+{
+	uint8_t brightness = FastLED.getBrightness();
+	if( transitionLength > 0 )
+	{
+		// ramp up to whatever brightness the effect set, for this
+		// frame only, so the effect's own setting is left alone
+		uint32_t elapsed = millis() - transitionStart;
+		if( elapsed >= transitionLength )
+		{
+			transitionLength = 0;
+		}
+		else
+		{
+			brightness = (brightness * elapsed) / transitionLength;
+		}
+	}
+	prepared = false;
+	boolean corrected = false;
+	if( dithering )
+	{
+		// correction and brightness are applied at 16 bits before
+		// dithering, so neither may be applied again at 8
+		dither->render(leds, brightness);
+		brightness = 255;
+		corrected = true;
+	}
+	if( pipeline != 0 )
+	{
+		// wait for the output side to free a buffer; if the effect is
+		// told to stop meanwhile, drop the frame rather than hang on a
+		// stalled consumer
+		CRGB *frame;
+		while( (frame = pipeline->acquire()) == 0 )
+		{
+			if( running() == false )
+			{
+				return;
+			}
+			yield();
+		}
+		memcpy(frame, leds, sizeof(CRGB) * stripLength);
+		pipeline->publish(brightness, corrected);
+	}
+	else
+	{
+		pushFrame(leds, stripLength, brightness, corrected);
+	}
+	if( recorder != 0 )
+	{
+		recorder->record(leds, brightness, corrected);
+	}
+}
+
+/**
+ * Sends one frame to the strip, through the output stage's driver if
+ * one is set.  corrected frames already carry the strip's color
+ * correction and go out without it.
+ */
+void NeopixelWrapper::pushFrame(CRGB *frame, uint16_t count, uint8_t brightness, boolean corrected)
+{
+	CRGB correction = corrected ? CRGB(UncorrectedColor) : CRGB(DEFAULT_CORRECTION);
+
+	if( output != 0 && output->hasDriver() && output->getNumLeds() == count )
+	{
+		output->setCorrection(correction);
+		output->setBrightness(brightness);
+		output->update(frame);
+		output->send();
+		return;
+	}
+
+	FastLED[0].setLeds(frame, count);
+	FastLED[0].setCorrection(correction);
+	FastLED.show(brightness);
+}
+
+/**
+ * Converts a per-frame fade amount, tuned at DEFAULT_FPS, into the amount
+ * that gives the same decay over the time the last frame actually took.
+ */
+uint8_t NeopixelWrapper::frameFade(uint8_t amount)
+{
+	uint8_t keep = 255 - amount;
+	uint8_t remaining = 255;
+	uint8_t whole = nominalFrames >> 8;
+	uint8_t fraction = nominalFrames & 0xFF;
+
+	if( whole > 0 )
+	{
+		remaining = keep;
+		whole--;
+	}
+	while( whole > 0 )
+	{
+		remaining = scale8(remaining, keep);
+		whole--;
+	}
+	if( fraction )
+	{
+		remaining = scale8(remaining, 255 - scale8(amount, fraction));
+	}
+
+	return 255 - remaining;
+}
+
+/**
+ * Fades the strip toward black.  With sparse fade enabled only pixels
+ * flagged in the active bitmap are touched, eight dark pixels are skipped
+ * per zero byte, and pixels that reach black are dropped from the map.
+ * Black pixels are unchanged by a fade, so the result matches
+ * fadeToBlackBy() over the whole strip.
+ */
+void NeopixelWrapper::fadeStrip(uint8_t amount)
+{
+	if( activeMap == 0 )
+	{
+		fadeToBlackBy(leds, stripLength, frameFade(amount));
+		return;
+	}
+
+	uint8_t scale = 255 - frameFade(amount);
+	uint16_t numBytes = (stripLength + 7) / 8;
+	for(uint16_t b=0; b<numBytes; b++)
+	{
+		uint8_t bits = activeMap[b];
+		if( bits == 0 )
+		{
+			continue;
+		}
+		CRGB *pixel = &leds[b << 3];
+		for(uint8_t mask=0x01; mask!=0; mask<<=1, pixel++)
+		{
+			if( bits & mask )
+			{
+				pixel->nscale8(scale);
+				if( !*pixel )
+				{
+					bits &= ~mask;
+				}
+			}
+		}
+		activeMap[b] = bits;
+	}
+}
+
+/**
+ * Flags every pixel as possibly lit.  Called when an effect starts since
+ * the strip may hold anything the previous effect left behind.
+ */
+void NeopixelWrapper::markAllActive()
+{
+	if( activeMap == 0 )
+	{
+		return;
+	}
+	uint16_t numBytes = (stripLength + 7) / 8;
+	memset(activeMap, 0xFF, numBytes);
+	// bits past the end of the strip must stay clear
+	if( stripLength & 0x07 )
+	{
+		activeMap[numBytes-1] = (1 << (stripLength & 0x07)) - 1;
+	}
+}
+
+/**
+ * Flags one pixel drawn straight into the strip as possibly lit
+ */
+void NeopixelWrapper::markActive(uint16_t index)
+{
+	if( activeMap != 0 )
+	{
+		activeMap[index >> 3] |= (1 << (index & 0x07));
+	}
+}
+
+/**
+ * Lights a pixel for one frame on top of what is there: as a one frame
+ * particle if a pool is attached, otherwise straight into the strip
+ */
+void NeopixelWrapper::spark(uint16_t index, CRGB c)
+{
+	if( particles != 0 )
+	{
+		particles->spawn(index, 0, c, 0, 1);
+		return;
+	}
+	leds[index] += c;
+	markActive(index);
+}
+
+/**
+ * Frame rate governor.  Measures what this frame cost to render and
+ * show, then waits out the rest of the frame period.  The period is the
+ * requested rate, stretched to the wire time of the strip and to the
+ * (smoothed) measured cost, so effects never ask for frames the strip
+ * can't display.  Also records how many DEFAULT_FPS frames the frame
+ * spanned so per-frame amounts can be scaled to elapsed time.
+ */
+void NeopixelWrapper::frameDelay()
+{
+	uint32_t cost = micros() - frameStart;
+	frameCost = frameCost - (frameCost >> 3) + (cost >> 3);
+
+	uint32_t period = 1000000UL / targetFps;
+	if( period < wireMicros() )
+	{
+		period = wireMicros();
+	}
+	if( period < frameCost )
+	{
+		period = frameCost;
+	}
+	framePeriod = period;
+
+	if( cost < period )
+	{
+		uint32_t remaining = period - cost;
+		delay(remaining / 1000);
+		delayMicroseconds(remaining % 1000);
+	}
+
+	uint32_t now = micros();
+	uint32_t elapsed = now - frameStart;
+	frameStart = now;
+	if( elapsed > 125000UL )
+	{
+		elapsed = 125000UL;
+	}
+	nominalFrames = ((elapsed >> 4) * DEFAULT_FPS * 256 + 31250) / 62500;
+}
+
+/**
+ * Restarts frame timing; called as an effect starts so time spent
+ * before it is not counted against its first frame
+ */
+void NeopixelWrapper::startFrames()
+{
+	frameStart = micros();
+	nominalFrames = 256;
+}
+
+/**
+ * Clears the particle pool and marks the whole strip for the sparse
+ * fade, unless prepareEffect() already did so since the last frame
+ */
+void NeopixelWrapper::startEffect()
+{
+	if( prepared == false )
+	{
+		if( particles != 0 )
+		{
+			particles->clear();
+		}
+		markAllActive();
+	}
+	prepared = false;
+}
+
+/**
+ * Switches the starting effect to 16 bit rendering if a dither buffer
+ * the size of the strip is attached.
+ *
+ * Returns true if the effect should render into dither
+ */
+boolean NeopixelWrapper::startDither()
+{
+	dithering = (dither != 0 && dither->getNumLeds() == stripLength);
+	return dithering;
+}
+
+/**
+ * Microseconds to clock the whole strip out and latch it
+ */
+uint32_t NeopixelWrapper::wireMicros()
+{
+	return (uint32_t)stripLength * LED_WIRE_MICROS + LED_LATCH_MICROS;
+}
+
+/**
+ * Returns true while the effect should keep going: no command has
+ * arrived and the deadline, if any, has not passed
+ */
+boolean NeopixelWrapper::running()
+{
+	if( hasDeadline && (int32_t)(millis() - deadline) >= 0 )
+	{
+		return false;
+	}
+	return isCommandAvailable() == false;
+}
+
+/**
+ * Waits between effect steps.  The wait is cut short at the deadline
+ * so a sequenced cue never overruns its slot.
+ *
+ * Returns true if the effect should stop
+ */
+uint8_t NeopixelWrapper::stepDelay(uint32_t time)
+{
+	if( hasDeadline )
+	{
+		int32_t left = (int32_t)(deadline - millis());
+		if( left <= 0 )
+		{
+			return true;
+		}
+		if( time > (uint32_t)left )
+		{
+			time = left;
+		}
+	}
+	if( hold(time) )
+	{
+		return true;
+	}
+	return !running();
+}
+
+/**
+ * Seeds the live parameters from an effect's arguments as it starts.
+ * Speed is not an effect argument and carries over between effects.
+ */
+void NeopixelWrapper::startParams(CRGB color1, CRGB color2, uint32_t onTime, uint32_t offTime, uint8_t intensity)
+{
+	// an interrupt always finishes its write before returning here, so
+	// this only waits on a writer on another core
+	while( claimParams() == false )
+	{
+		yield();
+	}
+	liveParams.color1 = color1;
+	liveParams.color2 = color2;
+	liveParams.onTime = onTime;
+	liveParams.offTime = offTime;
+	liveParams.intensity = intensity;
+	params = liveParams;
+	releaseParams();
+}
+
+/**
+ * Marks the live block as being written by making the sequence odd.
+ * Fails instead of waiting if another writer already holds it, so a
+ * write from an interrupt can never interleave with one it preempted.
+ */
+boolean NeopixelWrapper::claimParams()
+{
+	uint8_t sequence;
+#if defined(PARAMS_MULTICORE)
+	sequence = __atomic_load_n(&paramSequence, __ATOMIC_RELAXED);
+	if( (sequence & 0x01) ||
+		__atomic_compare_exchange_n(&paramSequence, &sequence, sequence + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false )
+	{
+		return false;
+	}
+#else
+	// one core, so only an interrupt can race; mask them for the claim
+	// and put the mask back as it was, so a claim made inside an
+	// interrupt handler does not turn interrupts back on
+#if defined(__AVR__)
+	uint8_t state = SREG;
+	cli();
+#elif defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
+	uint32_t state;
+	__asm__ volatile("mrs %0, primask\n\tcpsid i" : "=r" (state) :: "memory");
+#elif defined(ESP8266)
+	uint32_t state = xt_rsil(15);
+#else
+	// no saved state here: setParams() must not be called from a handler
+	noInterrupts();
+#endif
+	sequence = paramSequence;
+	if( (sequence & 0x01) == 0 )
+	{
+		paramSequence = sequence + 1;
+	}
+#if defined(__AVR__)
+	SREG = state;
+#elif defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
+	__asm__ volatile("msr primask, %0" :: "r" (state) : "memory");
+#elif defined(ESP8266)
+	xt_wsr_ps(state);
+#else
+	interrupts();
+#endif
+	if( sequence & 0x01 )
+	{
+		return false;
+	}
+#endif
+	// readers must see the odd sequence before any of the new fields
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	return true;
+}
+
+/**
+ * Publishes the block written since claimParams()
+ */
+void NeopixelWrapper::releaseParams()
+{
+	__atomic_store_n(&paramSequence, paramSequence + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Takes a consistent snapshot of the live parameters for this frame.
+ * An interrupt always finishes its write before the effect resumes, so
+ * this only waits on a writer on another core.
+ */
+void NeopixelWrapper::loadParams()
+{
+	while( copyParams(params) == false )
+	{
+		yield();
+	}
+}
+
+/**
+ * Copies the live parameters once.
+ *
+ * Returns false if a writer held the block or wrote it during the copy
+ */
+boolean NeopixelWrapper::copyParams(EffectParams &p)
+{
+	uint8_t before = __atomic_load_n(&paramSequence, __ATOMIC_ACQUIRE);
+	if( before & 0x01 )
+	{
+		return false;
+	}
+	p = liveParams;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&paramSequence, __ATOMIC_RELAXED) == before;
+}
+
+/**
+ * Advances the rotating base hue once every gHueUpdateTime milliseconds.
+ * Replaces the per-call-site EVERY_N_MILLISECONDS timers so all effects
+ * share a single timestamp.
+ */
+void NeopixelWrapper::updateHue()
+{
+	uint32_t now = millis();
+	if( (now - lastHueUpdate) >= gHueUpdateTime )
+	{
+		lastHueUpdate = now;
+		gHue++;
+	}
+}
+
+/**
+ * Wipes once across the strip with the live parameters.  Shared by
+ * wipe() and bounce(), so a bounce follows setParams() from pixel to
+ * pixel and between passes.
+ */
+void NeopixelWrapper::wipePass(uint8_t direction, uint8_t clearAfter, uint8_t clearEnd)
+{
+	loadParams();
+	fill(params.color2, true);
+	if( direction == LEFT)
+	{
+		for(uint16_t i=0; i<stripLength; i++)
+		{
+			loadParams();
+			setWipeColor(params.color1, i, params.onTime, params.offTime, clearAfter);
+			if(!running()) return;
+		}
+	}
+	else if (direction == RIGHT )
+	{
+		for(uint16_t i=stripLength; i>0; i--)
+		{
+			loadParams();
+			setWipeColor(params.color1, i-1, params.onTime, params.offTime, clearAfter);
+			if(!running()) return;
+		}
+	}
+
+	if( clearEnd )
+	{
+		loadParams();
+		fill(params.color2, true);
+	}
+}
+
 /**
  * Sets the color of the specified LED for onTime time.  If clearAfter
  * is true, returns color to original color and waits offTime before returning.
@@ -703,13 +1673,13 @@ void NeopixelWrapper::setWipeColor(CRGB newColor, uint16_t index, uint32_t onTim
 
     curColor = leds[index];
     leds[index] = newColor;
-    FastLED.show();
-    commandDelay(onTime);
+    showStrip();
+    stepDelay(onTime);
     if(clearAfter == true)
     {
         leds[index] = curColor;
-        FastLED.show();
-        commandDelay(offTime);
+        showStrip();
+        stepDelay(offTime);
     }
 
 }
@@ -10,10 +10,18 @@
 
 #include <Arduino.h>
 #include <FastLed.h>
+#include "NeopixelSpan.h"
+#include "NeopixelParticles.h"
+#include "NeopixelAudio.h"
+#include "NeopixelRecorder.h"
+#include "NeopixelFrameQueue.h"
+#include "NeopixelOutput.h"
+#include "NeopixelDither.h"
 
 #define DEFAULT_LED_PIN		3
 #define DEFAULT_CONTROLLER	NEOPIXEL
 //#define DEFAULT_CONTROLLER	WS2812
+#define DEFAULT_CORRECTION	TypicalLEDStrip
 
 #define WHITE	CRGB::White
 #define BLACK	CRGB::Black
@@ -35,20 +43,80 @@
 #define OUT		1
 
 #define DEFAULT_FPS 	120
+#define DEFAULT_SPEED	128
+
+// Defined where setParams() can run on another core at the same time as
+// the effect; claims on the parameter block then use compare and swap.
+// Otherwise only an interrupt can race a writer and claims mask them.
+#if !defined(PARAMS_MULTICORE) && defined(ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+#define PARAMS_MULTICORE
+#endif
+
+// WS2812/NEOPIXEL wire timing: 24 bits at 800KHz per LED plus the latch
+#define LED_WIRE_MICROS		30
+#define LED_LATCH_MICROS	50
+
+/*
+ * RAM usage
+ *
+ * Static RAM is the wrapper object itself (sizeof(NeopixelWrapper)) plus
+ * the pixel buffer allocated by initialize() (3 bytes per LED) and, with
+ * sparse fade enabled, the active pixel bitmap (1 bit per LED).  An
+ * attached NeopixelParticles pool adds 12 bytes per MAX_PARTICLES, an
+ * attached NeopixelOutput 3 bytes per LED of shadow plus 3 or 4 of wire
+ * buffer, and an attached NeopixelDither 9 bytes per LED.  Effects keep
+ * no function-local statics or EVERY_N_MILLISECONDS timers; all timing
+ * state lives in the wrapper and palettes are read directly from flash.
+ *
+ * Per-effect stack usage comes from building with -fstack-usage;
+ * tools/NeopixelMemory.sh collects the .su entries for every effect and,
+ * given the .elf, lists static RAM.  The bench sketch prints the object
+ * sizes and per-LED allocations on the target.
+ */
 
 
+/**
+ * Parameters a running effect reads every frame.  Each effect seeds the
+ * block from its arguments; a controller can then change any field with
+ * setParams() while the effect keeps running.
+ */
+struct EffectParams
+{
+	CRGB color1;		// color / onColor / color1 / glitterColor
+	CRGB color2;		// offColor / color2
+	uint32_t onTime;
+	uint32_t offTime;
+	uint8_t intensity;	// confetti fade amount, rainbow glitter probability
+	uint8_t speed;		// DEFAULT_SPEED = normal; scales motion and tempo
+};
 
 class NeopixelWrapper
 {
 public:
 	NeopixelWrapper();
-	boolean initialize(uint8_t numLeds, uint8_t intensity);
+	boolean initialize(uint16_t numLeds, uint8_t intensity);
 	void setFramesPerSecond(uint8_t fps);
 	uint8_t getFramesPerSecond();
+	uint16_t getMaxFramesPerSecond();
 	void setHueUpdateTime(uint8_t updateTime);
 	uint8_t getHueUpdateTime();
 	void setIntensity(uint8_t i);
 	uint8_t getIntensity();
+	boolean setParams(const EffectParams &p);
+	boolean getParams(EffectParams &p);
+	void setDeadline(uint32_t when);
+	void clearDeadline();
+	void setTransition(uint16_t time);
+	uint8_t hold(uint32_t time);
+	void prepareEffect();
+	boolean setSparseFade(boolean enable);
+	void setParticles(NeopixelParticles *p);
+	void setAudio(NeopixelAudio *a);
+	void setRecorder(NeopixelRecorder *r);
+	boolean setPipeline(NeopixelFrameQueue *queue);
+	boolean setOutput(NeopixelOutput *out);
+	void setDither(NeopixelDither *d);
+	boolean transmit();
 
     void fill(CRGB color, uint8_t show);
     void fillPattern(uint8_t pattern, CRGB onColor, CRGB offColor);
@@ -71,12 +139,58 @@ public:
 
 protected:
 	CRGB *leds;
+	uint16_t stripLength;
+	uint8_t *activeMap; // one bit per possibly lit pixel; null = full scan fade
 	uint8_t intensity;
 	uint8_t gHue; // rotating "base color" used by many of the patterns
 	uint8_t sparkleCount;
-	uint8_t frameWaitTime;
+	uint8_t targetFps;
+	uint32_t framePeriod; // governed frame period in microseconds
+	uint32_t frameStart;
+	uint32_t frameCost; // smoothed render + show time in microseconds
+	uint16_t nominalFrames; // DEFAULT_FPS frames the last frame spanned, 8.8
+	EffectParams liveParams; // written by setParams()
+	uint8_t paramSequence; // odd while liveParams is being written
+	EffectParams params; // snapshot the effect reads this frame
+	uint32_t deadline; // millis() at which effects return, if hasDeadline
+	boolean hasDeadline;
+	uint32_t transitionStart;
+	uint16_t transitionLength; // fade in time; 0 = none
+	boolean prepared; // prepareEffect() ran since the last frame
 	uint8_t gHueUpdateTime;
-
+	uint32_t lastHueUpdate; // shared timer for gHue rotation
+	uint16_t fadePseudotime; // rainbowFade phase state
+	uint16_t fadeLastMillis;
+	uint16_t fadeHue16;
+	NeopixelParticles *particles; // moves the dots of confetti, cylon and juggle when set
+	NeopixelAudio *audio; // drives bpm, juggle and confetti when set
+	NeopixelRecorder *recorder; // records every frame shown when set
+	NeopixelFrameQueue *pipeline; // frames go to another core when set
+	NeopixelOutput *output; // converts frames to wire format when set
+	NeopixelDither *dither; // 16 bit rendering for fade and rainbowFade when set
+	boolean dithering; // the running effect renders into dither
+
+	void showStrip();
+	void pushFrame(CRGB *frame, uint16_t count, uint8_t brightness, boolean corrected);
+	void frameDelay();
+	void startFrames();
+	boolean startDither();
+	void startEffect();
+	uint32_t wireMicros();
+	uint8_t frameFade(uint8_t amount);
+	boolean running();
+	uint8_t stepDelay(uint32_t time);
+	void startParams(CRGB color1, CRGB color2, uint32_t onTime, uint32_t offTime, uint8_t intensity);
+	void loadParams();
+	boolean claimParams();
+	void releaseParams();
+	boolean copyParams(EffectParams &p);
+	void updateHue();
+	void fadeStrip(uint8_t amount);
+	void markAllActive();
+	void markActive(uint16_t index);
+	void spark(uint16_t index, CRGB c);
+	void wipePass(uint8_t direction, uint8_t clearAfter, uint8_t clearEnd);
 	void setWipeColor(CRGB newColor, uint16_t index, uint32_t onTime, uint32_t offTime, uint8_t clearAfter);
 
 
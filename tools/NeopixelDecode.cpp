@@ -0,0 +1,156 @@
+/*
+ * NeopixelDecode.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Host tool that turns a NeopixelRecorder dump back into frames.
+ *
+ *   g++ -I.. -o NeopixelDecode NeopixelDecode.cpp
+ *   NeopixelDecode recording.bin          one text line per frame
+ *   NeopixelDecode -p recording.bin > out.ppm   one image row per frame
+ *
+ * Text lines are "<ms> <brightness> RRGGBB RRGGBB ...".  Records ahead
+ * of the first keyframe are skipped since the frame they modify was
+ * dropped from the ring.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "NeopixelRecordFormat.h"
+
+static uint16_t get16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+int main(int argc, char **argv)
+{
+	bool ppm = false;
+	const char *path = 0;
+
+	for(int i=1; i<argc; i++)
+	{
+		if( strcmp(argv[i], "-p") == 0 )
+		{
+			ppm = true;
+		}
+		else
+		{
+			path = argv[i];
+		}
+	}
+	if( path == 0 )
+	{
+		fprintf(stderr, "usage: %s [-p] recording\n", argv[0]);
+		return 1;
+	}
+
+	FILE *in = fopen(path, "rb");
+	if( in == 0 )
+	{
+		perror(path);
+		return 1;
+	}
+	std::vector<uint8_t> data;
+	uint8_t buffer[4096];
+	size_t n;
+	while( (n = fread(buffer, 1, sizeof(buffer), in)) > 0 )
+	{
+		data.insert(data.end(), buffer, buffer + n);
+	}
+	fclose(in);
+
+	if( data.size() < RECORD_FILE_HEADER || memcmp(&data[0], RECORD_MAGIC, RECORD_MAGIC_BYTES) != 0 )
+	{
+		fprintf(stderr, "%s: not a recording\n", path);
+		return 1;
+	}
+
+	uint16_t numLeds = get16(&data[RECORD_MAGIC_BYTES]);
+	std::vector<uint8_t> frame(numLeds * 3, 0);
+	std::vector<uint8_t> image;
+	std::vector<uint8_t> pixels;
+	uint32_t time = 0;
+	uint32_t frames = 0;
+	bool synced = false;
+
+	size_t pos = RECORD_FILE_HEADER;
+	while( pos + RECORD_HEADER <= data.size() )
+	{
+		uint16_t length = get16(&data[pos]);
+		if( length < RECORD_HEADER || pos + length > data.size() )
+		{
+			fprintf(stderr, "%s: truncated record at %lu\n", path, (unsigned long) pos);
+			break;
+		}
+		const uint8_t *rec = &data[pos];
+		const uint8_t *end = rec + length;
+		uint8_t brightness = rec[4];
+		uint8_t flags = rec[5];
+
+		if( synced )
+		{
+			time += get16(&rec[2]);
+		}
+		if( flags & RECORD_KEYFRAME )
+		{
+			synced = true;
+		}
+		pos += length;
+		if( !synced )
+		{
+			continue;
+		}
+
+		const uint8_t *p = rec + RECORD_HEADER;
+		while( p + RECORD_SPAN_HEADER <= end )
+		{
+			uint16_t pixel = get16(p);
+			uint16_t count = get16(p + 2);
+			p += RECORD_SPAN_HEADER;
+			while( count > 0 && p + RECORD_RUN <= end )
+			{
+				uint8_t run = p[0];
+				for(uint8_t r=0; r<run && count>0; r++, count--, pixel++)
+				{
+					if( pixel < numLeds )
+					{
+						memcpy(&frame[pixel * 3], p + 1, 3);
+					}
+				}
+				p += RECORD_RUN;
+			}
+		}
+
+		frames++;
+		if( ppm )
+		{
+			// apply brightness so the image shows what the strip showed
+			for(size_t i=0; i<frame.size(); i++)
+			{
+				image.push_back((frame[i] * (brightness + 1)) >> 8);
+			}
+		}
+		else
+		{
+			printf("%u %u", time, brightness);
+			for(uint16_t i=0; i<numLeds; i++)
+			{
+				printf(" %02X%02X%02X", frame[i*3], frame[i*3+1], frame[i*3+2]);
+			}
+			printf("\n");
+		}
+	}
+
+	if( ppm )
+	{
+		printf("P6\n%u %u\n255\n", numLeds, frames);
+		fwrite(image.data(), 1, image.size(), stdout);
+	}
+
+	return 0;
+}
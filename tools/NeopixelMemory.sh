@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# NeopixelMemory.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: tsasala
+#
+# Lists the RAM each effect uses.  Build with -fstack-usage added to the
+# C++ flags, e.g. for arduino-cli
+#
+#   arduino-cli compile --build-path build \
+#       --build-property compiler.cpp.extra_flags=-fstack-usage ...
+#   tools/NeopixelMemory.sh build build/sketch.ino.elf
+#
+# Stack is the frame of each effect and of the wrapper functions it calls,
+# from the .su files.  Static is every data and bss object in the .elf,
+# if one is given: the wrapper and its helpers under the sketch's names
+# plus FastLED's own state.  Set NM to the target's nm (avr-nm,
+# xtensa-esp32-elf-nm, ...); the host nm is used otherwise.
+#
+
+if [ $# -lt 1 ]; then
+	echo "usage: $0 <build dir> [firmware.elf]" >&2
+	exit 1
+fi
+
+BUILD=$1
+ELF=$2
+NM=${NM:-nm}
+EFFECTS="fill fillPattern pattern wipe bounce middle randomFlash fade strobe lightning rainbow rainbowFade confetti cylon bpm juggle"
+
+SU=$(find "$BUILD" -name 'Neopixel*.su' 2>/dev/null)
+if [ -z "$SU" ]; then
+	echo "no Neopixel*.su files under $BUILD; rebuild with -fstack-usage" >&2
+	exit 1
+fi
+
+# .su lines are "file:line:col:function<TAB>bytes<TAB>qualifier"
+echo "Stack per effect (bytes)"
+for effect in $EFFECTS; do
+	cat $SU | awk -F'\t' -v fn="NeopixelWrapper::$effect(" '
+		index($1, fn) { printf "  %-14s %6d  %s\n", substr(fn, 18, length(fn) - 18), $2, $3 }'
+done
+
+echo
+echo "Deepest library functions (bytes)"
+cat $SU | awk -F'\t' '
+	/Neopixel/ && !/NeopixelBench/ {
+		name = $1
+		sub(/^.*:[0-9]+:[0-9]+:/, "", name)
+		sub(/\(.*$/, "", name)
+		print $2 "\t" name
+	}' | sort -rn | head -20 | awk -F'\t' '{ printf "  %-40s %6d\n", $2, $1 }'
+
+if [ -n "$ELF" ]; then
+	echo
+	echo "Static RAM (bytes)"
+	$NM -C -S -t d --size-sort "$ELF" | awk '
+		$3 ~ /^[bBdD]$/ { size = $2 + 0; name = $4; for(i=5; i<=NF; i++) name = name " " $i;
+			printf "  %-40s %6d\n", name, size; total += size }
+		END { printf "  %-40s %6d\n", "total", total }'
+	echo "  plus heap: 3 bytes per LED, see RAM usage in NeopixelWrapper.h"
+fi
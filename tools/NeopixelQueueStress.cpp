@@ -0,0 +1,157 @@
+/*
+ * NeopixelQueueStress.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Host harness for the pipelined output path.  One thread renders
+ * numbered frames into a NeopixelFrameQueue, another transmits them, and
+ * every frame is checked for tearing and order on the way out.
+ *
+ *   g++ -std=c++11 -pthread -Ihost -I.. -o NeopixelQueueStress \
+ *       NeopixelQueueStress.cpp ../NeopixelFrameQueue.cpp
+ *   NeopixelQueueStress [-n frames] [-l leds] [-r renderUs] [-w wireUs]
+ *
+ * renderUs and wireUs busy-wait on each side to model render cost and
+ * time on the wire; by default the wire takes what a WS2812 strip of
+ * that length would.  Reports throughput, publish to release latency and
+ * producer stalls.
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include "NeopixelFrameQueue.h"
+
+// WS2812 wire time per LED plus latch, as in NeopixelWrapper.h
+#define LED_WIRE_MICROS		30
+#define LED_LATCH_MICROS	50
+
+static std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+uint32_t micros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+uint32_t millis()
+{
+	return micros() / 1000;
+}
+
+int analogRead(uint8_t pin)
+{
+	return 512;
+}
+
+static void spin(uint32_t us)
+{
+	uint32_t start = micros();
+	while( micros() - start < us )
+	{
+	}
+}
+
+/**
+ * Transmit side: checks each frame carries its sequence number in every
+ * pixel and that frames arrive in order
+ */
+static void transmit(NeopixelFrameQueue *queue, uint32_t count, uint32_t wireUs, uint32_t *errors)
+{
+	uint16_t numLeds = queue->getNumLeds();
+	for(uint32_t expect=0; expect<count; )
+	{
+		CRGB *frame = queue->peek();
+		if( frame == 0 )
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		for(uint16_t i=0; i<numLeds; i++)
+		{
+			if( frame[i].r != (uint8_t) expect || frame[i].g != (uint8_t)(expect >> 8) || frame[i].b != (uint8_t) i )
+			{
+				(*errors)++;
+				break;
+			}
+		}
+		if( queue->getBrightness() != (uint8_t)(expect >> 16) )
+		{
+			(*errors)++;
+		}
+		spin(wireUs);
+		queue->release();
+		expect++;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t count = 20000;
+	uint16_t numLeds = 300;
+	uint32_t renderUs = 0;
+	int32_t wireUs = -1;
+
+	for(int i=1; i+1<argc; i+=2)
+	{
+		if( strcmp(argv[i], "-n") == 0 )
+		{
+			count = atol(argv[i+1]);
+		}
+		else if( strcmp(argv[i], "-l") == 0 )
+		{
+			numLeds = atoi(argv[i+1]);
+		}
+		else if( strcmp(argv[i], "-r") == 0 )
+		{
+			renderUs = atol(argv[i+1]);
+		}
+		else if( strcmp(argv[i], "-w") == 0 )
+		{
+			wireUs = atol(argv[i+1]);
+		}
+	}
+	if( wireUs < 0 )
+	{
+		wireUs = (uint32_t) numLeds * LED_WIRE_MICROS + LED_LATCH_MICROS;
+	}
+
+	NeopixelFrameQueue queue;
+	if( queue.begin(numLeds) == false )
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	uint32_t errors = 0;
+	uint32_t start = micros();
+	std::thread consumer(transmit, &queue, count, (uint32_t) wireUs, &errors);
+
+	for(uint32_t n=0; n<count; n++)
+	{
+		spin(renderUs);
+		CRGB *frame;
+		while( (frame = queue.acquire()) == 0 )
+		{
+			std::this_thread::yield();
+		}
+		for(uint16_t i=0; i<numLeds; i++)
+		{
+			frame[i].r = n;
+			frame[i].g = n >> 8;
+			frame[i].b = i;
+		}
+		queue.publish(n >> 16, false);
+	}
+	consumer.join();
+	uint32_t elapsed = micros() - start;
+
+	uint32_t frames = queue.getFrames();
+	printf("frames=%u leds=%u render_us=%u wire_us=%d\n", frames, numLeds, renderUs, wireUs);
+	printf("fps=%.1f latency_us=%u max_latency_us=%u stalls=%u errors=%u\n",
+		elapsed ? frames * 1e6 / elapsed : 0.0,
+		frames ? queue.getLatencyMicros() / frames : 0,
+		queue.getMaxLatencyMicros(), queue.getStalls(), errors);
+
+	return errors ? 1 : 0;
+}
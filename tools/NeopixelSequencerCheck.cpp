@@ -0,0 +1,257 @@
+/*
+ * NeopixelSequencerCheck.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Host check for NeopixelSequencer.  Plays short shows through the real
+ * wrapper on a simulated clock and checks every frame FastLED is asked
+ * to show: that cues start on time and that fade in transitions ramp
+ * smoothly, including for effects that show one frame and then wait.
+ *
+ *   g++ -std=c++11 -Ihost -I.. -o NeopixelSequencerCheck \
+ *       NeopixelSequencerCheck.cpp ../Neopixel*.cpp
+ *   NeopixelSequencerCheck [-v]
+ *
+ * -v prints every frame as "<ms> RRGGBB <brightness>".  Exits non-zero
+ * if any check fails.
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "NeopixelSequencer.h"
+
+#define CHECK_LEDS			10
+#define CHECK_INTENSITY		200
+
+// simulated time; only delays move it, so results are exact
+static uint32_t now = 0;
+
+uint32_t micros()
+{
+	return now;
+}
+
+uint32_t millis()
+{
+	return now / 1000;
+}
+
+void delay(uint32_t ms)
+{
+	now += ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us)
+{
+	now += us;
+}
+
+int analogRead(uint8_t pin)
+{
+	return 512;
+}
+
+uint8_t isCommandAvailable()
+{
+	return false;
+}
+
+uint8_t commandDelay(uint32_t time)
+{
+	delay(time);
+	return false;
+}
+
+struct Frame
+{
+	uint32_t ms;		// from the start of the show
+	uint32_t color;		// first pixel
+	uint8_t brightness;
+};
+
+CFastLED FastLED;
+static std::vector<Frame> frames;
+static uint32_t origin = 0;
+static bool verbose = false;
+static int failures = 0;
+
+void CFastLED::show(uint8_t scale)
+{
+	Frame f;
+	f.ms = millis() - origin;
+	f.color = controller.data[0];
+	f.brightness = scale;
+	frames.push_back(f);
+	if( verbose )
+	{
+		printf("  %5u %06X %3u\n", f.ms, f.color, f.brightness);
+	}
+}
+
+static NeopixelWrapper strip;
+
+static Cue cue(uint32_t start, uint32_t duration, uint8_t effect, CRGB color1, CRGB color2, uint32_t onTime, uint16_t fade)
+{
+	Cue c = Cue();
+	c.start = start;
+	c.duration = duration;
+	c.effect = effect;
+	c.pattern = 0x0F;
+	c.direction = LEFT;
+	c.transition = fade ? TRANSITION_FADE : TRANSITION_CUT;
+	c.transitionTime = fade;
+	c.params.color1 = color1;
+	c.params.color2 = color2;
+	c.params.onTime = onTime;
+	c.params.offTime = onTime;
+	c.params.speed = DEFAULT_SPEED;
+	return c;
+}
+
+static void play(const char *name, const Cue *cues, uint8_t count)
+{
+	NeopixelSequencer sequencer;
+
+	if( verbose )
+	{
+		printf("%s\n", name);
+	}
+	strip.setIntensity(CHECK_INTENSITY);
+	frames.clear();
+	origin = millis();
+	sequencer.begin(&strip, cues, count);
+	sequencer.start();
+	sequencer.run();
+}
+
+static void report(const char *name, bool ok, const char *detail)
+{
+	printf("%-24s %s  %s\n", name, ok ? "ok  " : "FAIL", detail);
+	if( !ok )
+	{
+		failures++;
+	}
+}
+
+/**
+ * Checks the frames in [from, to) ramp up without steps larger than
+ * maxStep and reach full by the end of the fade
+ */
+static void checkRamp(const char *name, uint32_t from, uint32_t fade, uint32_t to, uint8_t full, uint8_t maxStep)
+{
+	char detail[96];
+	uint32_t count = 0;
+	uint8_t last = 0;
+	uint8_t biggest = 0;
+	bool rising = true;
+	int32_t fullAt = -1;
+
+	for(size_t i=0; i<frames.size(); i++)
+	{
+		const Frame &f = frames[i];
+		if( f.ms < from || f.ms >= to )
+		{
+			continue;
+		}
+		if( count > 0 )
+		{
+			if( f.brightness < last )
+			{
+				rising = false;
+			}
+			else if( f.brightness - last > biggest )
+			{
+				biggest = f.brightness - last;
+			}
+		}
+		if( f.brightness == full && fullAt < 0 )
+		{
+			fullAt = f.ms - from;
+		}
+		last = f.brightness;
+		count++;
+	}
+
+	bool ok = rising && count > 1 && biggest <= maxStep && fullAt >= 0 && (uint32_t) fullAt <= fade + 10;
+	snprintf(detail, sizeof(detail), "%u frames, largest step %u, full after %d ms", count, biggest, fullAt);
+	report(name, ok, detail);
+}
+
+/**
+ * Checks the first frame at or after start is at the given brightness
+ */
+static void checkFirst(const char *name, uint32_t start, uint8_t brightness)
+{
+	char detail[96];
+	for(size_t i=0; i<frames.size(); i++)
+	{
+		if( frames[i].ms >= start )
+		{
+			snprintf(detail, sizeof(detail), "first frame at %u ms, brightness %u", frames[i].ms, frames[i].brightness);
+			report(name, frames[i].ms == start && frames[i].brightness == brightness, detail);
+			return;
+		}
+	}
+	report(name, false, "no frame");
+}
+
+int main(int argc, char **argv)
+{
+	for(int i=1; i<argc; i++)
+	{
+		if( strcmp(argv[i], "-v") == 0 )
+		{
+			verbose = true;
+		}
+	}
+
+	if( strip.initialize(CHECK_LEDS, CHECK_INTENSITY) == false )
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	// fill shows a single frame, so the fade has to come from the hold
+	Cue fillFade[] =
+	{
+		cue(0, 600, EFFECT_FILL, CRGB::Red, CRGB::Black, 0, 300),
+		cue(600, 200, EFFECT_FILL, CRGB::Blue, CRGB::Black, 0, 0),
+	};
+	play("fill fade", fillFade, 2);
+	checkRamp("fill fade ramp", 0, 300, 600, CHECK_INTENSITY, 16);
+	checkFirst("fill fade next cue", 600, CHECK_INTENSITY);
+
+	// a pattern steps every 250 ms; the fade must not follow the steps
+	Cue patternFade[] =
+	{
+		cue(0, 800, EFFECT_PATTERN, CRGB::Green, CRGB::Black, 250, 300),
+	};
+	play("pattern fade", patternFade, 1);
+	checkRamp("pattern fade ramp", 0, 300, 800, CHECK_INTENSITY, 16);
+
+	// a cue shorter than its fade must not pass the rest on
+	Cue shortFade[] =
+	{
+		cue(0, 100, EFFECT_FILL, CRGB::Green, CRGB::Black, 0, 400),
+		cue(100, 200, EFFECT_FILL, CRGB::White, CRGB::Black, 0, 0),
+	};
+	play("short fade", shortFade, 2);
+	checkFirst("short fade next cue", 100, CHECK_INTENSITY);
+
+	// cues start on time back to back; strobe fades in to its own 255
+	Cue timing[] =
+	{
+		cue(0, 200, EFFECT_FILL, CRGB::Red, CRGB::Black, 0, 0),
+		cue(200, 400, EFFECT_STROBE, CRGB::Blue, CRGB(0, 0, 1), 50, 100),
+		cue(600, 300, EFFECT_WIPE, CRGB::Green, CRGB::Black, 10, 0),
+	};
+	play("timing", timing, 3);
+	checkFirst("timing fill", 0, CHECK_INTENSITY);
+	checkFirst("timing strobe", 200, 0);
+	checkRamp("timing strobe ramp", 200, 100, 600, 255, 32);
+	checkFirst("timing wipe", 600, 255);
+
+	printf("%s\n", failures ? "FAILED" : "passed");
+	return failures ? 1 : 0;
+}
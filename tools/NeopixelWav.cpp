@@ -0,0 +1,167 @@
+/*
+ * NeopixelWav.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Host tool that runs a 16 bit PCM WAV file through NeopixelAudio, so the
+ * FFT and beat detector can be checked against known music.
+ *
+ *   g++ -Ihost -I.. -o NeopixelWav NeopixelWav.cpp ../NeopixelAudio.cpp
+ *   NeopixelWav [-b blockSize] music.wav
+ *
+ * One line per block: "<ms> <level> <hue> <bpm> <beat>", where ms is the
+ * position in the file, followed by the beat count and the average host
+ * time per analyze() call.  Only the first channel is used.  The sample
+ * rate must fit in 16 bits (up to 48kHz).
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include "NeopixelAudio.h"
+
+// position in the file drives the beat detector's clock
+static uint32_t position = 0;
+
+uint32_t millis()
+{
+	return position;
+}
+
+uint32_t micros()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000UL + ts.tv_nsec / 1000;
+}
+
+int analogRead(uint8_t pin)
+{
+	return 512;
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+	return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+int main(int argc, char **argv)
+{
+	uint16_t blockSize = DEFAULT_AUDIO_BLOCK;
+	const char *path = 0;
+
+	for(int i=1; i<argc; i++)
+	{
+		if( strcmp(argv[i], "-b") == 0 && i + 1 < argc )
+		{
+			blockSize = atoi(argv[++i]);
+		}
+		else
+		{
+			path = argv[i];
+		}
+	}
+	if( path == 0 )
+	{
+		fprintf(stderr, "usage: %s [-b blockSize] file.wav\n", argv[0]);
+		return 1;
+	}
+
+	FILE *in = fopen(path, "rb");
+	if( in == 0 )
+	{
+		perror(path);
+		return 1;
+	}
+	std::vector<uint8_t> data;
+	uint8_t buffer[4096];
+	size_t n;
+	while( (n = fread(buffer, 1, sizeof(buffer), in)) > 0 )
+	{
+		data.insert(data.end(), buffer, buffer + n);
+	}
+	fclose(in);
+
+	if( data.size() < 12 || memcmp(&data[0], "RIFF", 4) != 0 || memcmp(&data[8], "WAVE", 4) != 0 )
+	{
+		fprintf(stderr, "%s: not a WAV file\n", path);
+		return 1;
+	}
+
+	// walk the chunks for the format and the samples
+	uint16_t channels = 0;
+	uint32_t sampleRate = 0;
+	const uint8_t *pcm = 0;
+	uint32_t pcmBytes = 0;
+	size_t pos = 12;
+	while( pos + 8 <= data.size() )
+	{
+		uint32_t size = get32(&data[pos + 4]);
+		const uint8_t *body = &data[pos + 8];
+		if( size > data.size() - pos - 8 )
+		{
+			size = data.size() - pos - 8;
+		}
+		if( memcmp(&data[pos], "fmt ", 4) == 0 && size >= 16 )
+		{
+			if( get16(body) != 1 || get16(body + 14) != 16 )
+			{
+				fprintf(stderr, "%s: only 16 bit PCM is supported\n", path);
+				return 1;
+			}
+			channels = get16(body + 2);
+			sampleRate = get32(body + 4);
+		}
+		else if( memcmp(&data[pos], "data", 4) == 0 )
+		{
+			pcm = body;
+			pcmBytes = size;
+		}
+		pos += 8 + size + (size & 1);
+	}
+	if( channels == 0 || pcm == 0 || sampleRate > 0xFFFF )
+	{
+		fprintf(stderr, "%s: no usable fmt/data chunks\n", path);
+		return 1;
+	}
+
+	NeopixelAudio audio;
+	if( audio.begin(blockSize, sampleRate) == false )
+	{
+		fprintf(stderr, "block size must be a power of two up to %u\n", AUDIO_MAX_BLOCK);
+		return 1;
+	}
+
+	uint32_t frames = pcmBytes / (2 * channels);
+	int16_t samples[AUDIO_MAX_BLOCK];
+	uint32_t blocks = 0;
+	uint32_t beats = 0;
+	uint32_t spent = 0;
+	for(uint32_t f=0; f + blockSize <= frames; f += blockSize)
+	{
+		for(uint16_t i=0; i<blockSize; i++)
+		{
+			samples[i] = (int16_t) get16(pcm + (f + i) * 2 * channels);
+		}
+		position = ((uint64_t)(f + blockSize) * 1000) / sampleRate;
+
+		uint32_t start = micros();
+		audio.analyze(samples, blockSize);
+		spent += micros() - start;
+		blocks++;
+
+		boolean beat = audio.getBeat();
+		beats += beat;
+		printf("%u %u %u %u %u\n", position, audio.getLevel(), audio.getHue(), audio.getBeatsPerMinute(), beat);
+	}
+
+	fprintf(stderr, "%u blocks, %u beats, %.2f us per analyze\n", blocks, beats, blocks ? (double) spent / blocks : 0.0);
+
+	return 0;
+}
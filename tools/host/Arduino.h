@@ -0,0 +1,81 @@
+/*
+ * Arduino.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Host stand-in for the Arduino core, just enough to build the library
+ * into the host tools.  Each tool supplies millis(), micros() and
+ * analogRead(), and delay() and delayMicroseconds() if it runs effects,
+ * so it can run on real or simulated time.
+ */
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+int analogRead(uint8_t pin);
+
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+
+template<class T> inline T min(T a, T b)
+{
+	return (b < a) ? b : a;
+}
+
+template<class T> inline T max(T a, T b)
+{
+	return (a < b) ? b : a;
+}
+
+inline long random(long howbig)
+{
+	return howbig > 0 ? rand() % howbig : 0;
+}
+
+inline long random(long howsmall, long howbig)
+{
+	return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+inline void yield()
+{
+}
+
+// one core and no interrupt handlers on the host
+inline void noInterrupts()
+{
+}
+
+inline void interrupts()
+{
+}
+
+class Print
+{
+public:
+	virtual ~Print()
+	{
+	}
+	virtual size_t write(uint8_t b) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size)
+	{
+		for(size_t i=0; i<size; i++)
+		{
+			write(buffer[i]);
+		}
+		return size;
+	}
+};
+
+#endif /* HOST_ARDUINO_H_ */
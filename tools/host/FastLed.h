@@ -0,0 +1,386 @@
+/*
+ * FastLed.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: tsasala
+ *
+ * Host stand-in for the parts of FastLED the library uses.  sin16/cos16,
+ * scale8 and the random generator are reproduced so host results match
+ * the device; HSV and palette colors are close but not exact.  A tool
+ * that runs effects defines the FastLED object and CFastLED::show(),
+ * which is where it sees every frame.
+ */
+
+#ifndef HOST_FASTLED_H_
+#define HOST_FASTLED_H_
+
+#include "Arduino.h"
+
+typedef uint8_t fract8;
+typedef uint16_t fract16;
+typedef uint16_t accum88;
+
+inline uint8_t scale8(uint8_t i, fract8 scale)
+{
+	return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale)
+{
+	return (((uint16_t)i * scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+inline uint16_t scale16(uint16_t i, fract16 scale)
+{
+	return ((uint32_t)i * (1 + (uint32_t)scale)) >> 16;
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j)
+{
+	uint16_t t = i + j;
+	return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j)
+{
+	return i > j ? i - j : 0;
+}
+
+inline int16_t sin16(uint16_t theta)
+{
+	static const uint16_t base[] = { 0, 6393, 12539, 18204, 23170, 27245, 30273, 32137 };
+	static const uint8_t slope[] = { 49, 48, 44, 38, 31, 23, 14, 4 };
+
+	uint16_t offset = (theta & 0x3FFF) >> 3;
+	if( theta & 0x4000 )
+	{
+		offset = 2047 - offset;
+	}
+	uint8_t section = offset / 256;
+	uint16_t mx = slope[section] * (uint8_t)((uint8_t)offset / 2);
+	int16_t y = mx + base[section];
+	if( theta & 0x8000 )
+	{
+		y = -y;
+	}
+	return y;
+}
+
+inline int16_t cos16(uint16_t theta)
+{
+	return sin16(theta + 16384);
+}
+
+inline uint16_t &rand16seed()
+{
+	static uint16_t seed = 1337;
+	return seed;
+}
+
+inline uint8_t random8()
+{
+	rand16seed() = rand16seed() * 2053 + 13849;
+	return (uint8_t)(rand16seed() + (rand16seed() >> 8));
+}
+
+inline uint8_t random8(uint8_t lim)
+{
+	return (random8() * lim) >> 8;
+}
+
+inline uint16_t random16()
+{
+	rand16seed() = rand16seed() * 2053 + 13849;
+	return rand16seed();
+}
+
+inline uint16_t random16(uint16_t lim)
+{
+	return ((uint32_t)random16() * lim) >> 16;
+}
+
+inline uint16_t beat88(accum88 bpm88, uint32_t timebase = 0)
+{
+	return ((millis() - timebase) * bpm88 * 280) >> 16;
+}
+
+inline uint16_t beat16(accum88 bpm, uint32_t timebase = 0)
+{
+	// whole beats per minute below 256, 8.8 fixed point above
+	if( bpm < 256 )
+	{
+		bpm <<= 8;
+	}
+	return beat88(bpm, timebase);
+}
+
+inline uint16_t beatsin88(accum88 bpm88, uint16_t lowest = 0, uint16_t highest = 65535, uint32_t timebase = 0, uint16_t phase = 0)
+{
+	uint16_t beatsin = sin16(beat88(bpm88, timebase) + phase) + 32768;
+	return lowest + scale16(beatsin, highest - lowest);
+}
+
+inline uint16_t beatsin16(accum88 bpm, uint16_t lowest = 0, uint16_t highest = 65535, uint32_t timebase = 0, uint16_t phase = 0)
+{
+	uint16_t beatsin = sin16(beat16(bpm, timebase) + phase) + 32768;
+	return lowest + scale16(beatsin, highest - lowest);
+}
+
+inline uint8_t beatsin8(accum88 bpm, uint8_t lowest = 0, uint8_t highest = 255, uint32_t timebase = 0, uint8_t phase = 0)
+{
+	uint8_t beatsin = (sin16(beat16(bpm, timebase) + (phase << 8)) + 32768) >> 8;
+	return lowest + scale8(beatsin, highest - lowest);
+}
+
+struct CHSV
+{
+	uint8_t h;
+	uint8_t s;
+	uint8_t v;
+
+	CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv)
+	{
+	}
+};
+
+enum LEDColorCorrection
+{
+	TypicalLEDStrip = 0xFFB0F0,
+	UncorrectedColor = 0xFFFFFF
+};
+
+struct CRGB
+{
+	union
+	{
+		struct
+		{
+			uint8_t r;
+			uint8_t g;
+			uint8_t b;
+		};
+		uint8_t raw[3];
+	};
+
+	enum HTMLColorCode
+	{
+		Black = 0x000000,
+		Blue = 0x0000FF,
+		Cyan = 0x00FFFF,
+		Green = 0x008000,
+		Magenta = 0xFF00FF,
+		Orange = 0xFFA500,
+		Purple = 0x800080,
+		Red = 0xFF0000,
+		White = 0xFFFFFF,
+		Yellow = 0xFFFF00
+	};
+
+	CRGB()
+	{
+	}
+
+	CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib)
+	{
+	}
+
+	CRGB(uint32_t colorcode) : r(colorcode >> 16), g(colorcode >> 8), b(colorcode)
+	{
+	}
+
+	// six sector spectrum; FastLED's rainbow mapping differs slightly
+	CRGB(const CHSV &hsv)
+	{
+		uint8_t region = hsv.h / 43;
+		uint8_t rest = (hsv.h - region * 43) * 6;
+		uint8_t p = scale8(hsv.v, 255 - hsv.s);
+		uint8_t q = scale8(hsv.v, 255 - scale8(hsv.s, rest));
+		uint8_t t = scale8(hsv.v, 255 - scale8(hsv.s, 255 - rest));
+		switch( region )
+		{
+		case 0: r = hsv.v; g = t; b = p; break;
+		case 1: r = q; g = hsv.v; b = p; break;
+		case 2: r = p; g = hsv.v; b = t; break;
+		case 3: r = p; g = q; b = hsv.v; break;
+		case 4: r = t; g = p; b = hsv.v; break;
+		default: r = hsv.v; g = p; b = q; break;
+		}
+	}
+
+	operator uint32_t() const
+	{
+		return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+	}
+
+	operator bool() const
+	{
+		return r || g || b;
+	}
+
+	CRGB &operator+=(const CRGB &rhs)
+	{
+		r = qadd8(r, rhs.r);
+		g = qadd8(g, rhs.g);
+		b = qadd8(b, rhs.b);
+		return *this;
+	}
+
+	CRGB &operator|=(const CRGB &rhs)
+	{
+		r = max(r, rhs.r);
+		g = max(g, rhs.g);
+		b = max(b, rhs.b);
+		return *this;
+	}
+
+	CRGB &nscale8(uint8_t scale)
+	{
+		r = scale8(r, scale);
+		g = scale8(g, scale);
+		b = scale8(b, scale);
+		return *this;
+	}
+
+	CRGB &nscale8_video(uint8_t scale)
+	{
+		r = scale8_video(r, scale);
+		g = scale8_video(g, scale);
+		b = scale8_video(b, scale);
+		return *this;
+	}
+};
+
+inline bool operator==(const CRGB &a, const CRGB &b)
+{
+	return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+inline bool operator!=(const CRGB &a, const CRGB &b)
+{
+	return !(a == b);
+}
+
+inline void fadeToBlackBy(CRGB *leds, uint16_t count, uint8_t fadeBy)
+{
+	for(uint16_t i=0; i<count; i++)
+	{
+		leds[i].nscale8(255 - fadeBy);
+	}
+}
+
+inline void fill_solid(CRGB *leds, int count, const CRGB &color)
+{
+	for(int i=0; i<count; i++)
+	{
+		leds[i] = color;
+	}
+}
+
+inline void fill_rainbow(CRGB *leds, int count, uint8_t hue, uint8_t deltaHue = 5)
+{
+	for(int i=0; i<count; i++, hue += deltaHue)
+	{
+		leds[i] = CHSV(hue, 240, 255);
+	}
+}
+
+inline void nblend(CRGB &existing, const CRGB &overlay, fract8 amount)
+{
+	for(uint8_t c=0; c<3; c++)
+	{
+		existing.raw[c] += (((int16_t)overlay.raw[c] - existing.raw[c]) * amount) >> 8;
+	}
+}
+
+typedef uint32_t TProgmemRGBPalette16[16];
+
+static const TProgmemRGBPalette16 PartyColors_p =
+{
+	0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+	0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+
+// nearest entry, no blending between entries
+inline CRGB ColorFromPalette(const TProgmemRGBPalette16 &palette, uint8_t index, uint8_t brightness = 255)
+{
+	CRGB c(palette[index >> 4]);
+	return c.nscale8_video(brightness);
+}
+
+class CLEDController
+{
+public:
+	CRGB *data;
+	int count;
+	CRGB correction;
+
+	CLEDController() : data(0), count(0), correction(UncorrectedColor)
+	{
+	}
+
+	CLEDController &setLeds(CRGB *leds, int numLeds)
+	{
+		data = leds;
+		count = numLeds;
+		return *this;
+	}
+
+	CLEDController &setCorrection(CRGB c)
+	{
+		correction = c;
+		return *this;
+	}
+};
+
+template<uint8_t DATA_PIN> class NEOPIXEL
+{
+};
+
+class CFastLED
+{
+public:
+	CLEDController controller;
+	uint8_t brightness;
+
+	CFastLED() : brightness(255)
+	{
+	}
+
+	template<template<uint8_t> class CHIPSET, uint8_t DATA_PIN>
+	CLEDController &addLeds(CRGB *leds, int numLeds)
+	{
+		return controller.setLeds(leds, numLeds);
+	}
+
+	CLEDController &operator[](int x)
+	{
+		return controller;
+	}
+
+	int size()
+	{
+		return controller.count;
+	}
+
+	void setBrightness(uint8_t scale)
+	{
+		brightness = scale;
+	}
+
+	uint8_t getBrightness()
+	{
+		return brightness;
+	}
+
+	void show()
+	{
+		show(brightness);
+	}
+
+	// supplied by the tool
+	void show(uint8_t scale);
+};
+
+extern CFastLED FastLED;
+
+#endif /* HOST_FASTLED_H_ */